@@ -5,7 +5,16 @@
  ******************************************************************************/
 #include "Tab5UI.h"
 #include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <new>
 #include <algorithm>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#endif
 
 // ═════════════════════════════════════════════════════════════════════════════
 //  Tab5UI Runtime Screen Dimensions
@@ -22,6 +31,15 @@ void Tab5UI::init(M5GFX& gfx) {
 int16_t Tab5UI::screenW() { return _tab5ScreenW; }
 int16_t Tab5UI::screenH() { return _tab5ScreenH; }
 
+// ─────────────────────────────────────────────────────────────────────────────
+//  Millisecond clock — millis() unless replaced via UIManager::setClock()
+// ─────────────────────────────────────────────────────────────────────────────
+static UIManager::ClockSource _uiClock = nullptr;
+
+static inline unsigned long uiMillis() {
+    return _uiClock ? _uiClock() : millis();
+}
+
 // ─────────────────────────────────────────────────────────────────────────────
 //  Helper: Convert 24-bit RGB888 to M5GFX-compatible uint32_t color
 // ─────────────────────────────────────────────────────────────────────────────
@@ -40,6 +58,619 @@ static inline uint32_t darken(uint32_t c, uint8_t amount = 40) {
     return (uint32_t)((r << 16) | (g << 8) | b);
 }
 
+// True if two rects overlap (empty rects never overlap)
+static inline bool rectsOverlap(int32_t ax, int32_t ay, int32_t aw, int32_t ah,
+                                int32_t bx, int32_t by, int32_t bw, int32_t bh) {
+    return aw > 0 && ah > 0 && bw > 0 && bh > 0 &&
+           ax < bx + bw && ax + aw > bx &&
+           ay < by + bh && ay + ah > by;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Render statistics (see UIStats in Tab5UI.h)
+// ─────────────────────────────────────────────────────────────────────────────
+// Samples go into fixed rings so collection never allocates; min/avg/p99
+// are only computed when getStats() is called.
+
+// min/avg/p99 of n samples; sorts v in place
+static UIStat summarizeSamples(uint32_t* v, size_t n) {
+    UIStat st;
+    if (n == 0) return st;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += v[i];
+    std::sort(v, v + n);
+    st.min = v[0];
+    st.avg = (uint32_t)(sum / n);
+    st.p99 = v[std::min<size_t>(n - 1, (n * 99) / 100)];
+    return st;
+}
+
+#if TAB5_STATS
+struct StatRing {
+    uint32_t v[TAB5_STATS_WINDOW];
+    uint16_t count = 0;
+    uint16_t head  = 0;
+
+    void add(uint32_t x) {
+        v[head] = x;
+        head = (head + 1) % TAB5_STATS_WINDOW;
+        if (count < TAB5_STATS_WINDOW) count++;
+    }
+
+    UIStat summary() const {
+        uint32_t sorted[TAB5_STATS_WINDOW];
+        memcpy(sorted, v, count * sizeof(uint32_t));
+        return summarizeSamples(sorted, count);
+    }
+};
+
+// The sample rings come to several KB, so they are only allocated when
+// collection is first enabled
+struct StatsRings {
+    StatRing frameUs, drawUs, touchUs, pixels, dirty;
+    struct Tag {
+        char     tag[16];
+        StatRing drawUs;
+    } tags[TAB5_STATS_MAX_TAGS];
+};
+
+struct StatsState {
+    bool        enabled = false;   // Only set once `r` is allocated
+    StatsRings* r       = nullptr;
+    uint32_t frames       = 0;
+    uint32_t spriteAllocs = 0;
+    // Accumulated over the current frame
+    uint32_t framePixels  = 0;
+    uint32_t frameDirty   = 0;
+    int      fullDepth    = 0;   // >0 while inside a full container draw
+    int      tagCount     = 0;
+};
+static StatsState _stats;
+
+static inline void statsCountPixels(int32_t w, int32_t h) {
+    if (_stats.enabled && w > 0 && h > 0) _stats.framePixels += (uint32_t)(w * h);
+}
+
+static void statsRecordDraw(const char* tag, uint32_t us) {
+    if (!tag || !tag[0]) tag = "-";
+    StatsRings::Tag* t = nullptr;
+    for (int i = 0; i < _stats.tagCount; i++) {
+        if (strncmp(_stats.r->tags[i].tag, tag, sizeof(t->tag) - 1) == 0) {
+            t = &_stats.r->tags[i];
+            break;
+        }
+    }
+    if (!t) {
+        if (_stats.tagCount >= TAB5_STATS_MAX_TAGS) return;
+        t = &_stats.r->tags[_stats.tagCount++];
+        strncpy(t->tag, tag, sizeof(t->tag) - 1);
+        t->tag[sizeof(t->tag) - 1] = '\0';
+        t->drawUs.count = t->drawUs.head = 0;
+    }
+    t->drawUs.add(us);
+}
+
+// Times one element draw and counts the pixels it covers.  A dirty
+// container clears and repaints its whole area, so its children are not
+// counted again.
+struct StatsDrawScope {
+    UIElement* elem = nullptr;
+    uint32_t   t0   = 0;
+    bool       full = false;
+
+    StatsDrawScope(LovyanGFX& gfx, UIElement* e) {
+        if (!_stats.enabled) return;
+        elem = e;
+        t0 = micros();
+        full = e->isContainer() && e->isDirty();
+        bool leaf = !e->isContainer();
+        if ((full || leaf) && _stats.fullDepth == 0) {
+            int32_t px, py, pw, ph;
+            gfx.getClipRect(&px, &py, &pw, &ph);
+            int32_t x0 = std::max<int32_t>(px, e->getX());
+            int32_t y0 = std::max<int32_t>(py, e->getY());
+            int32_t x1 = std::min<int32_t>(px + pw, e->getX() + e->getWidth());
+            int32_t y1 = std::min<int32_t>(py + ph, e->getY() + e->getHeight());
+            statsCountPixels(x1 - x0, y1 - y0);
+        }
+        if (full || leaf) _stats.frameDirty++;
+        if (full) _stats.fullDepth++;
+    }
+    ~StatsDrawScope() {
+        if (!elem) return;
+        if (full) _stats.fullDepth--;
+        statsRecordDraw(elem->getTag(), micros() - t0);
+    }
+};
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Event tracing (see UIManager::setTraceEnabled)
+// ─────────────────────────────────────────────────────────────────────────────
+// Completed spans go into a fixed ring as (name, tag, start, duration), so
+// a span costs one micros() pair and a 24-byte write.  Names and tags are
+// stored as pointers; element tags are expected to outlive the trace.
+enum class TraceCat : uint8_t { FRAME, DISPATCH, DRAW, PUSH, REFLOW, SORT, CALLBACK };
+
+#if TAB5_TRACE
+static const char* const TRACE_CAT_NAMES[] = {
+    "frame", "dispatch", "draw", "push", "reflow", "sort", "callback"
+};
+
+struct TraceEvent {
+    const char* name;
+    const char* tag;
+    uint32_t    ts;
+    uint32_t    dur;
+    uint32_t    arg;
+    TraceCat    cat;
+};
+
+struct TraceState {
+    bool        enabled = false;
+    TraceEvent* ring    = nullptr;
+    size_t      cap     = 0;
+    size_t      head    = 0;
+    size_t      count   = 0;
+    uint32_t    total   = 0;   // Spans ever recorded (wraps)
+};
+static TraceState _trace;
+
+static void traceRecord(TraceCat cat, const char* name, const char* tag,
+                        uint32_t ts, uint32_t dur, uint32_t arg = 0) {
+    if (!_trace.enabled) return;
+    TraceEvent& ev = _trace.ring[_trace.head];
+    ev.name = name;
+    ev.tag  = tag;
+    ev.ts   = ts;
+    ev.dur  = dur;
+    ev.arg  = arg;
+    ev.cat  = cat;
+    _trace.head = (_trace.head + 1) % _trace.cap;
+    if (_trace.count < _trace.cap) _trace.count++;
+    _trace.total++;
+}
+
+struct TraceScope {
+    TraceCat    cat;
+    const char* name;
+    const char* tag;
+    uint32_t    arg;
+    uint32_t    t0 = 0;
+    bool        on;
+
+    TraceScope(TraceCat c, const char* n, const char* t = nullptr, uint32_t a = 0)
+        : cat(c), name(n), tag(t), arg(a), on(_trace.enabled) {
+        if (on) t0 = micros();
+    }
+    ~TraceScope() {
+        if (on) traceRecord(cat, name, tag, t0, micros() - t0, arg);
+    }
+};
+#else
+struct TraceScope {
+    TraceScope(TraceCat, const char*, const char* = nullptr, uint32_t = 0) {}
+};
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Redraw-region overlay (see UIManager::setRedrawOverlay)
+// ─────────────────────────────────────────────────────────────────────────────
+// Each rectangle written to the panel is recorded, clipped to the current
+// clip rect.  Nested writes (a dirty container's children, a widget's own
+// sprite push) are covered by the outermost one and not recorded again.
+// Identical rects share a slot, so repeated repaints of the same widget
+// accumulate in one counter.
+struct RedrawRegion {
+    int16_t       x, y, w, h;
+    uint32_t      total;       // Times written since the overlay was enabled
+    uint16_t      frameHits;   // Times written in the current pass
+    uint8_t       level;       // Hits in the pass that last wrote it (1..3)
+    bool          shown;       // Outline currently on screen
+    unsigned long shownMs;
+};
+
+static constexpr int           REDRAW_REGION_SLOTS = 32;
+static constexpr unsigned long REDRAW_OUTLINE_MS   = 300;
+
+struct RedrawState {
+    LovyanGFX*   panel    = nullptr;   // nullptr = overlay off
+    bool         mute     = false;     // Pass that erases expired outlines
+    bool         recorded = false;     // Something was recorded this pass
+    int          depth    = 0;
+    int          count    = 0;
+    RedrawRegion regions[REDRAW_REGION_SLOTS];
+};
+static RedrawState _redraw;
+
+static void redrawRecord(LovyanGFX& gfx, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (&gfx != _redraw.panel || _redraw.mute || _redraw.depth > 0) return;
+    int32_t px, py, pw, ph;
+    gfx.getClipRect(&px, &py, &pw, &ph);
+    int32_t x0 = std::max(px, x);
+    int32_t y0 = std::max(py, y);
+    int32_t x1 = std::min(px + pw, x + w);
+    int32_t y1 = std::min(py + ph, y + h);
+    if (x1 <= x0 || y1 <= y0) return;
+
+    RedrawRegion* slot = nullptr;
+    RedrawRegion* spare = nullptr;
+    for (int i = 0; i < _redraw.count; i++) {
+        RedrawRegion& rg = _redraw.regions[i];
+        if (rg.x == x0 && rg.y == y0 && rg.w == x1 - x0 && rg.h == y1 - y0) {
+            slot = &rg;
+            break;
+        }
+        // Reuse the least recently shown slot whose outline is gone
+        if (!rg.shown && rg.frameHits == 0 && (!spare || rg.shownMs < spare->shownMs)) {
+            spare = &rg;
+        }
+    }
+    if (!slot) {
+        if (_redraw.count < REDRAW_REGION_SLOTS) slot = &_redraw.regions[_redraw.count++];
+        else if (spare) slot = spare;
+        else return;   // Every slot is on screen; drop this one
+        slot->x = x0;  slot->y = y0;
+        slot->w = x1 - x0;  slot->h = y1 - y0;
+        slot->total = 0;
+        slot->frameHits = 0;
+        slot->shown = false;
+        slot->shownMs = 0;
+    }
+    slot->total++;
+    slot->frameHits++;
+    _redraw.recorded = true;
+}
+
+// Records one panel write and suppresses recording of writes nested in it
+struct RedrawScope {
+    bool nested = false;
+
+    RedrawScope(LovyanGFX& gfx, int32_t x, int32_t y, int32_t w, int32_t h) {
+        if (&gfx != _redraw.panel) return;
+        redrawRecord(gfx, x, y, w, h);
+        _redraw.depth++;
+        nested = true;
+    }
+    ~RedrawScope() {
+        if (nested) _redraw.depth--;
+    }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Overdraw tracking (see UIManager::setOverdrawTracking)
+// ─────────────────────────────────────────────────────────────────────────────
+// Counts how many separate paints land on each TAB5_OVERDRAW_CELL-square
+// cell of the panel per pass: every element draw at any nesting depth (a
+// container's clear and then each child on top), keyboard key repaints,
+// modal erases, and sprite pushes that are not part of an element draw
+// (save-under restores, tab page blits).  A widget's own layers inside
+// its sprite are a single paint.
+struct OverdrawState {
+    LovyanGFX* panel     = nullptr;   // nullptr = tracking off
+    uint8_t*   cur       = nullptr;   // Paints per cell, current pass
+    uint8_t*   peak      = nullptr;   // Highest per-cell count since reset
+    uint16_t   cellsX    = 0;
+    uint16_t   cellsY    = 0;
+    int        drawDepth = 0;         // >0 inside an element draw
+    bool       recorded  = false;
+    uint32_t   frames    = 0;
+    uint32_t   lastCells = 0;         // Cells painted in the last pass
+    uint32_t   lastPaints = 0;        // Paints over those cells
+};
+static OverdrawState _overdraw;
+
+static void overdrawRecord(LovyanGFX& gfx, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (&gfx != _overdraw.panel) return;
+    int32_t px, py, pw, ph;
+    gfx.getClipRect(&px, &py, &pw, &ph);
+    int32_t x0 = std::max(px, x);
+    int32_t y0 = std::max(py, y);
+    int32_t x1 = std::min(px + pw, x + w);
+    int32_t y1 = std::min(py + ph, y + h);
+    if (x1 <= x0 || y1 <= y0) return;
+
+    const int cs = TAB5_OVERDRAW_CELL;
+    int cx0 = x0 / cs, cy0 = y0 / cs;
+    int cx1 = std::min<int>((x1 - 1) / cs, _overdraw.cellsX - 1);
+    int cy1 = std::min<int>((y1 - 1) / cs, _overdraw.cellsY - 1);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        uint8_t* row = _overdraw.cur + cy * _overdraw.cellsX;
+        for (int cx = cx0; cx <= cx1; cx++) {
+            if (row[cx] < 255) row[cx]++;
+        }
+    }
+    _overdraw.recorded = true;
+}
+
+// Counts an element draw and marks writes inside it as part of it
+struct OverdrawScope {
+    bool nested = false;
+
+    OverdrawScope(LovyanGFX& gfx, UIElement* e) {
+        if (&gfx != _overdraw.panel) return;
+        overdrawRecord(gfx, e->getX(), e->getY(), e->getWidth(), e->getHeight());
+        _overdraw.drawDepth++;
+        nested = true;
+    }
+    ~OverdrawScope() {
+        if (nested) _overdraw.drawDepth--;
+    }
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Touch-to-photon latency (see UIManager::setLatencyTracking)
+// ─────────────────────────────────────────────────────────────────────────────
+// Every write to the panel bumps a sequence number and stamps its end
+// time; update() compares them against the touch sample that caused the
+// pass.
+struct LatencyState {
+    bool          enabled   = false;
+    LovyanGFX*    panel     = nullptr;   // Set by UIManager
+    uint32_t      writeSeq  = 0;
+    uint32_t      writeEndUs = 0;
+    int           typeCount = 0;
+    UILatencyHist types[TAB5_LATENCY_MAX_TYPES];
+};
+static LatencyState _latency;
+
+static inline void notePanelWrite(LovyanGFX& gfx) {
+    if (&gfx != _latency.panel) return;
+    _latency.writeSeq++;
+    _latency.writeEndUs = micros();
+}
+
+// Stamps the end of a panel write on scope exit
+struct PanelWriteScope {
+    LovyanGFX& gfx;
+    explicit PanelWriteScope(LovyanGFX& g) : gfx(g) {}
+    ~PanelWriteScope() { notePanelWrite(gfx); }
+};
+
+static void latencyRecord(const char* type, uint32_t us) {
+    UILatencyHist* h = nullptr;
+    for (int i = 0; i < _latency.typeCount; i++) {
+        if (strcmp(_latency.types[i].type, type) == 0) { h = &_latency.types[i]; break; }
+    }
+    if (!h) {
+        if (_latency.typeCount >= TAB5_LATENCY_MAX_TYPES) return;
+        h = &_latency.types[_latency.typeCount++];
+        *h = UILatencyHist();
+        h->type = type;
+    }
+    int b = 0;
+    while (b < TAB5_LATENCY_BUCKETS - 1 && us >= TAB5_LATENCY_BOUNDS_MS[b] * 1000UL) b++;
+    h->buckets[b]++;
+    h->count++;
+    h->totalUs += us;
+    if (us > h->maxUs) h->maxUs = us;
+}
+
+// Type of the widget a gesture landed on, looking through containers.
+// Resolved at dispatch time: a callback may delete the element.
+static const char* latencyTypeOf(UIElement* e) {
+    if (!_latency.enabled || !e) return nullptr;
+    while (e->isContainer()) {
+        UIElement* c = static_cast<UIContainer*>(e)->getTouchedChild();
+        if (!c) break;
+        e = c;
+    }
+    UIMemoryInfo m;
+    e->memoryInfo(m);
+    return m.type;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  User callbacks — watchdog and deferred queue (see setDeferredCallbacks)
+// ─────────────────────────────────────────────────────────────────────────────
+// A queued call keeps a pointer to the widget's std::function and a copy
+// of the (small, trivially copyable) arguments, so queueing never
+// allocates.
+struct DeferredCall {
+    void (*invoke)(const DeferredCall&);
+    const UIElement* owner;
+    const void*      cb;
+    const char*      name;
+    alignas(8) unsigned char args[16];
+};
+
+struct CallbackState {
+    bool         defer     = false;
+    bool         deferring = false;   // Inside update()'s touch dispatch
+    uint32_t     budgetUs  = TAB5_CALLBACK_BUDGET_US;
+    DeferredCall queue[TAB5_CALLBACK_QUEUE];
+    int          queued    = 0;
+    int          overrunCount = 0;
+    UICallbackOverrun overruns[TAB5_CALLBACK_MAX_OVERRUNS];
+    UIManager::CallbackOverrunHandler onOverrun;
+};
+static CallbackState _callbacks;
+
+// Defers callbacks fired during touch dispatch while in scope
+struct CallbackDeferScope {
+    CallbackDeferScope()  { _callbacks.deferring = _callbacks.defer; }
+    ~CallbackDeferScope() { end(); }
+    void end()            { _callbacks.deferring = false; }
+};
+
+static const char* callbackTag(const UIElement* owner) {
+    if (!owner) return "UIManager";
+    if (owner->getTag() && owner->getTag()[0]) return owner->getTag();
+    UIMemoryInfo m;
+    owner->memoryInfo(m);
+    return m.type;
+}
+
+static void callbackOverrun(const UIElement* owner, const char* name, uint32_t us) {
+    const char* tag = callbackTag(owner);
+    UICallbackOverrun* o = nullptr;
+    for (int i = 0; i < _callbacks.overrunCount; i++) {
+        UICallbackOverrun& c = _callbacks.overruns[i];
+        if (strcmp(c.tag, tag) == 0 && strcmp(c.name, name) == 0) { o = &c; break; }
+    }
+    if (!o && _callbacks.overrunCount < TAB5_CALLBACK_MAX_OVERRUNS) {
+        o = &_callbacks.overruns[_callbacks.overrunCount++];
+        *o = UICallbackOverrun();
+        o->tag  = tag;
+        o->name = name;
+    }
+    if (o) {
+        o->count++;
+        o->lastUs = us;
+        if (us > o->worstUs) o->worstUs = us;
+    }
+    if (_callbacks.onOverrun) _callbacks.onOverrun(tag, name, us);
+}
+
+// Run a callback inside a trace span and time it against the budget
+template <typename Cb, typename... Args>
+static void runCallback(const UIElement* owner, const char* name, const Cb& cb,
+                        Args&&... args) {
+    if (!cb) return;
+    uint32_t t0 = micros();
+    {
+        TraceScope trace(TraceCat::CALLBACK, name, owner ? owner->getTag() : nullptr);
+        cb(std::forward<Args>(args)...);
+    }
+    uint32_t us = micros() - t0;
+    if (_callbacks.budgetUs && us > _callbacks.budgetUs) callbackOverrun(owner, name, us);
+}
+
+template <typename Cb, typename... Args>
+struct DeferredInvoker {
+    using Tuple = std::tuple<typename std::decay<Args>::type...>;
+    static void run(const DeferredCall& d) {
+        call(d, std::index_sequence_for<Args...>());
+    }
+    template <size_t... I>
+    static void call(const DeferredCall& d, std::index_sequence<I...>) {
+        const Tuple& t = *reinterpret_cast<const Tuple*>(d.args);
+        runCallback(d.owner, d.name, *static_cast<const Cb*>(d.cb), std::get<I>(t)...);
+    }
+};
+
+// Invoke a user callback of `owner` (nullptr for UIManager's own), or
+// queue it while touch dispatch is deferring
+template <typename Cb, typename... Args>
+static inline void fireCallback(const UIElement* owner, const char* name, const Cb& cb,
+                                Args&&... args) {
+    if (!cb) return;
+    if (owner && _callbacks.deferring && _callbacks.queued < TAB5_CALLBACK_QUEUE) {
+        using Invoker = DeferredInvoker<Cb, Args...>;
+        using Tuple   = typename Invoker::Tuple;
+        static_assert(sizeof(Tuple) <= sizeof(DeferredCall::args) &&
+                      (std::is_trivially_copyable<typename std::decay<Args>::type>::value && ...),
+                      "deferred callback arguments must be small and trivially copyable");
+        DeferredCall& d = _callbacks.queue[_callbacks.queued++];
+        d.invoke = &Invoker::run;
+        d.owner  = owner;
+        d.cb     = &cb;
+        d.name   = name;
+        new (d.args) Tuple(std::forward<Args>(args)...);
+        return;
+    }
+    runCallback(owner, name, cb, std::forward<Args>(args)...);
+}
+
+// Run queued callbacks in order; returns how many ran.  Callbacks they
+// fire in turn run inline.
+static int drainDeferredCallbacks() {
+    int ran = 0;
+    for (int i = 0; i < _callbacks.queued; i++, ran++) {
+        DeferredCall d = _callbacks.queue[i];
+        if (d.invoke) d.invoke(d);
+    }
+    _callbacks.queued = 0;
+    return ran;
+}
+
+// Widget whose pressed state update() draws first (see drawFeedback)
+static UIElement* _feedbackElem = nullptr;
+
+// The widget a gesture landed on, looking through containers
+static UIElement* touchedLeaf(UIElement* e) {
+    while (e && e->isContainer()) {
+        UIElement* c = static_cast<UIContainer*>(e)->getTouchedChild();
+        if (!c) return nullptr;
+        e = c;
+    }
+    return e;
+}
+
+UIElement::~UIElement() {
+    // A queued callback would reference this element's std::function
+    for (int i = 0; i < _callbacks.queued; i++) {
+        if (_callbacks.queue[i].owner == this) _callbacks.queue[i].invoke = nullptr;
+    }
+    if (_feedbackElem == this) _feedbackElem = nullptr;
+}
+
+// pushSprite() inside a trace span
+static inline void pushTraced(M5Canvas* spr, LovyanGFX& gfx, int32_t x, int32_t y) {
+    TraceScope trace(TraceCat::PUSH, "pushSprite", nullptr,
+                     (uint32_t)(spr->width() * spr->height()));
+    RedrawScope region(gfx, x, y, spr->width(), spr->height());
+    if (_overdraw.drawDepth == 0) overdrawRecord(gfx, x, y, spr->width(), spr->height());
+    spr->pushSprite(&gfx, x, y);
+    notePanelWrite(gfx);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Allocation tracking (see TAB5_ALLOC_TRACK in Tab5UI.h)
+// ─────────────────────────────────────────────────────────────────────────────
+// Only the ESP-IDF heap hooks are used: replacing the global operator
+// new/delete from a library would clash with any sketch or other library
+// that does the same.
+#if TAB5_ALLOC_TRACK && !defined(CONFIG_HEAP_USE_HOOKS)
+#warning "TAB5_ALLOC_TRACK needs an ESP-IDF built with CONFIG_HEAP_USE_HOOKS; getAllocStats() will report tracking = false"
+#endif
+#if TAB5_ALLOC_TRACK && defined(CONFIG_HEAP_USE_HOOKS)
+#define TAB5_ALLOC_HOOKED 1
+static volatile uint32_t _allocCount = 0;
+static volatile uint32_t _freeCount  = 0;
+static volatile uint32_t _allocBytes = 0;
+
+// Called by the ESP-IDF heap for every allocation and free
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr; (void)caps;
+    __atomic_add_fetch(&_allocCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&_allocBytes, (uint32_t)size, __ATOMIC_RELAXED);
+}
+extern "C" void esp_heap_trace_free_hook(void* ptr) {
+    if (ptr) __atomic_add_fetch(&_freeCount, 1, __ATOMIC_RELAXED);
+}
+
+struct AllocState {
+    uint32_t frames, allocFrames, allocs, frees, bytes, maxAllocs, lastAllocs;
+};
+static AllocState _allocStats = {};
+
+// Attributes heap activity between construction and destruction to one
+// update() pass
+struct AllocFrameScope {
+    uint32_t a0 = _allocCount;
+    uint32_t f0 = _freeCount;
+    uint32_t b0 = _allocBytes;
+
+    ~AllocFrameScope() {
+        uint32_t a = _allocCount - a0;
+        _allocStats.frames++;
+        _allocStats.lastAllocs = a;
+        if (a == 0 && _freeCount == f0) return;
+        _allocStats.allocFrames++;
+        _allocStats.allocs += a;
+        _allocStats.frees  += _freeCount - f0;
+        _allocStats.bytes  += _allocBytes - b0;
+        if (a > _allocStats.maxAllocs) _allocStats.maxAllocs = a;
+    }
+};
+#else
+#define TAB5_ALLOC_HOOKED 0
+struct AllocFrameScope {
+    AllocFrameScope() {}
+};
+#endif
+
 // ─────────────────────────────────────────────────────────────────────────────
 //  Shared off-screen sprite for flicker-free drawing
 // ─────────────────────────────────────────────────────────────────────────────
@@ -49,6 +680,19 @@ static inline uint32_t darken(uint32_t c, uint8_t amount = 40) {
 static M5Canvas* _sharedSprite = nullptr;
 static int16_t   _spriteW = 0;
 static int16_t   _spriteH = 0;
+// The sprite draws into a grow-only buffer, so widgets of different sizes
+// taking turns with it re-point it instead of freeing and reallocating
+static void*     _spriteBuf = nullptr;
+static size_t    _spriteCap = 0;       // Bytes
+
+// Large pixel buffers go to PSRAM when there is any
+static void* allocPixels(size_t bytes) {
+#if defined(ESP32)
+    void* p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (p) return p;
+#endif
+    return malloc(bytes);
+}
 
 // Acquire the shared sprite sized to at least (w × h).
 // Returns nullptr if PSRAM allocation fails (caller should fall back to
@@ -75,14 +719,25 @@ static M5Canvas* acquireSprite(LovyanGFX* parent, int16_t w, int16_t h) {
         _sharedSprite->setColorDepth(16);
     }
 
-    // Resize if needed (createSprite frees previous buffer internally)
+    // Resize if needed.  Only growing past the largest size so far
+    // allocates; anything smaller reuses the buffer.
     if (w != _spriteW || h != _spriteH) {
-        _sharedSprite->deleteSprite();
-        if (!_sharedSprite->createSprite(w, h)) {
-            _spriteW = 0;
-            _spriteH = 0;
-            return nullptr;  // Allocation failed
+        size_t bytes = (size_t)w * h * 2;
+        if (bytes > _spriteCap) {
+#if TAB5_STATS
+            _stats.spriteAllocs++;
+#endif
+            _sharedSprite->deleteSprite();
+            free(_spriteBuf);
+            _spriteBuf = allocPixels(bytes);
+            _spriteCap = _spriteBuf ? bytes : 0;
+            if (!_spriteBuf) {
+                _spriteW = 0;
+                _spriteH = 0;
+                return nullptr;  // Allocation failed
+            }
         }
+        _sharedSprite->setBuffer(_spriteBuf, w, h);
         _spriteW = w;
         _spriteH = h;
     }
@@ -96,6 +751,309 @@ static M5Canvas* acquireSprite(LovyanGFX* parent, int16_t w, int16_t h) {
 #endif  // TAB5_RENDER_MODE != 2
 }
 
+// ─────────────────────────────────────────────────────────────────────────────
+//  Decoded icon cache
+// ─────────────────────────────────────────────────────────────────────────────
+// PNG icons are decoded once onto the solid colour they sit on and kept in
+// PSRAM, so redraws and scrolling are a blit instead of a decode (which
+// allocates).  Slots are keyed by (data, size, background) and replaced
+// round-robin; a replaced slot keeps its buffer when the new icon fits.
+#if TAB5_RENDER_MODE != 2
+struct IconSlot {
+    const uint8_t* data = nullptr;   // nullptr = slot free
+    uint32_t  bg  = 0;
+    int16_t   w = 0, h = 0;
+    M5Canvas* spr = nullptr;
+    void*     buf = nullptr;
+    size_t    cap = 0;               // Bytes
+};
+static IconSlot _icons[TAB5_ICON_CACHE];
+static int      _iconNext = 0;
+
+static M5Canvas* iconBitmap(const uint8_t* data, uint32_t size,
+                            int16_t w, int16_t h, uint32_t bg) {
+    for (auto& s : _icons) {
+        if (s.data == data && s.w == w && s.h == h && s.bg == bg) return s.spr;
+    }
+    IconSlot& s = _icons[_iconNext];
+    _iconNext = (_iconNext + 1) % TAB5_ICON_CACHE;
+    s.data = nullptr;
+
+    size_t bytes = (size_t)w * h * 2;
+    if (!s.spr) {
+        s.spr = new (std::nothrow) M5Canvas();
+        if (!s.spr) return nullptr;
+        s.spr->setColorDepth(16);
+    }
+    if (bytes > s.cap) {
+        s.spr->deleteSprite();
+        free(s.buf);
+        s.buf = allocPixels(bytes);
+        s.cap = s.buf ? bytes : 0;
+        if (!s.buf) return nullptr;
+    }
+    s.spr->setBuffer(s.buf, w, h);
+    s.spr->fillScreen(bg);
+    s.spr->drawPng(data, size, 0, 0, w, h);
+    s.data = data;
+    s.w = w;
+    s.h = h;
+    s.bg = bg;
+    return s.spr;
+}
+#endif
+
+// Draw a PNG icon at (x,y) scaled into w × h, over a solid `bg` (an
+// rgb888() value) that is already painted there
+static void drawIcon(LovyanGFX& gfx, const uint8_t* data, uint32_t size,
+                     int16_t x, int16_t y, int16_t w, int16_t h, uint32_t bg) {
+#if TAB5_RENDER_MODE != 2
+    if (M5Canvas* icon = iconBitmap(data, size, w, h, bg)) {
+        icon->pushSprite(&gfx, x, y);
+        return;
+    }
+#else
+    (void)bg;
+#endif
+    gfx.drawPng(data, size, x, y, w, h);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Save-under buffers for overlays (menus, popups, keyboard, dropdown lists)
+// ─────────────────────────────────────────────────────────────────────────────
+// When an overlay first draws, the pixels beneath its footprint are copied
+// into a PSRAM buffer.  After it closes, UIManager blits them back in one
+// transfer instead of erasing to the background and repainting everything
+// it covered.  Widgets that change while an overlay is open are drawn around
+// it (see drawElement()) and the covered part is recorded as damage, so only
+// those widgets are repainted after the restore.  Buffers stay allocated
+// between uses and are only resized when an overlay needs a different size.
+#if TAB5_SAVE_UNDER
+struct SaveUnder {
+    const UIElement* owner = nullptr;   // nullptr = slot free
+    M5Canvas* buf  = nullptr;
+    int16_t   x = 0, y = 0, w = 0, h = 0;
+    int16_t   bufW = 0, bufH = 0;
+    // Bounding box of stale pixels under the overlay (empty when x1 <= x0)
+    int16_t   dmgX0 = 0, dmgY0 = 0, dmgX1 = 0, dmgY1 = 0;
+};
+static constexpr int SAVE_UNDER_SLOTS = 4;
+static SaveUnder _saveUnders[SAVE_UNDER_SLOTS];
+#endif
+
+// An overlay still covering its footprint
+static inline bool isOverlayOpen(const UIElement* e) {
+    return e->isVisible() && (e->isMenu() || e->isPopup() || e->isKeyboard());
+}
+
+// True if `owner` currently holds a save-under snapshot
+static bool hasSaveUnder(const UIElement* owner) {
+#if TAB5_SAVE_UNDER
+    for (auto& s : _saveUnders) {
+        if (s.owner == owner) return true;
+    }
+#else
+    (void)owner;
+#endif
+    return false;
+}
+
+// True if any held snapshot overlaps the rect — those pixels may still show
+// an overlay (open, or closed but not yet restored)
+static bool saveUnderOverlaps(int16_t x, int16_t y, int16_t w, int16_t h) {
+#if TAB5_SAVE_UNDER
+    for (auto& s : _saveUnders) {
+        if (s.owner && rectsOverlap(x, y, w, h, s.x, s.y, s.w, s.h)) return true;
+    }
+#else
+    (void)x; (void)y; (void)w; (void)h;
+#endif
+    return false;
+}
+
+#if TAB5_SAVE_UNDER
+static void restoreSaveUnder(LovyanGFX& gfx, SaveUnder& s) {
+    pushTraced(s.buf, gfx, s.x, s.y);
+#if TAB5_STATS
+    statsCountPixels(s.w, s.h);
+#endif
+    s.owner = nullptr;
+}
+#endif
+
+// Snapshot the pixels under an overlay's footprint.  Called at the top of the
+// overlay's draw(), before it paints.  No-op if the snapshot already covers
+// the same rect; if the footprint moved, the old area is restored first.
+static void saveUnderCapture(LovyanGFX& gfx, const UIElement* owner,
+                             int16_t x, int16_t y, int16_t w, int16_t h) {
+#if TAB5_SAVE_UNDER
+    // Clamp to the screen — readRect outside the panel is undefined
+    int16_t x1 = std::min<int16_t>(x + w, Tab5UI::screenW());
+    int16_t y1 = std::min<int16_t>(y + h, Tab5UI::screenH());
+    x = std::max<int16_t>(x, 0);
+    y = std::max<int16_t>(y, 0);
+    w = x1 - x;
+    h = y1 - y;
+    if (w <= 0 || h <= 0) return;
+
+    SaveUnder* slot = nullptr;
+    for (auto& s : _saveUnders) {
+        if (s.owner != owner) continue;
+        if (s.x == x && s.y == y && s.w == w && s.h == h) return;
+        restoreSaveUnder(gfx, s);
+        slot = &s;
+        break;
+    }
+    if (!slot) {
+        for (auto& s : _saveUnders) {
+            if (!s.owner) { slot = &s; break; }
+        }
+    }
+    if (!slot) return;   // All slots busy — owner falls back to erase
+
+    if (!slot->buf) {
+        slot->buf = new (std::nothrow) M5Canvas(&gfx);
+        if (!slot->buf) return;
+        slot->buf->setColorDepth(16);
+        slot->buf->setPsram(true);
+    }
+    if (slot->bufW != w || slot->bufH != h) {
+        slot->buf->deleteSprite();
+        slot->bufW = slot->bufH = 0;
+        if (!slot->buf->createSprite(w, h)) return;
+        slot->bufW = w;
+        slot->bufH = h;
+    }
+
+    // M5Canvas stores 16-bit pixels byte-swapped, so read them that way
+    gfx.readRect(x, y, w, h, (lgfx::swap565_t*)slot->buf->getBuffer());
+    slot->owner = owner;
+    slot->x = x; slot->y = y; slot->w = w; slot->h = h;
+    slot->dmgX0 = slot->dmgY0 = slot->dmgX1 = slot->dmgY1 = 0;
+#else
+    (void)gfx; (void)owner; (void)x; (void)y; (void)w; (void)h;
+#endif
+}
+
+#if TAB5_SAVE_UNDER
+// True if slot `s` holds an open overlay that `e` must be drawn around.
+// Other overlays and the overlay's own ancestors are excluded: overlays
+// always paint in full, and ancestors redraw the overlay themselves.
+static bool occludes(const SaveUnder& s, const UIElement* e) {
+    if (!s.owner || s.owner == e || !isOverlayOpen(s.owner)) return false;
+    if (isOverlayOpen(e)) return false;
+    for (const UIElement* p = s.owner->getParent(); p; p = p->getParent()) {
+        if (p == e) return false;
+    }
+    return true;
+}
+
+// Draw `e` clipped to (cx,cy,cw,ch) minus every open overlay from slot
+// `first` on.  The region outside an overlay splits into up to four bands.
+static void drawAround(LovyanGFX& gfx, UIElement* e, int first,
+                       int32_t cx, int32_t cy, int32_t cw, int32_t ch) {
+    for (int i = first; i < SAVE_UNDER_SLOTS; i++) {
+        SaveUnder& s = _saveUnders[i];
+        if (!occludes(s, e)) continue;
+        if (!rectsOverlap(cx, cy, cw, ch, s.x, s.y, s.w, s.h)) continue;
+
+        int32_t ox0 = std::max<int32_t>(cx, s.x);
+        int32_t oy0 = std::max<int32_t>(cy, s.y);
+        int32_t ox1 = std::min<int32_t>(cx + cw, s.x + s.w);
+        int32_t oy1 = std::min<int32_t>(cy + ch, s.y + s.h);
+
+        // The covered part of the snapshot is now stale
+        if (s.dmgX1 <= s.dmgX0) {
+            s.dmgX0 = ox0; s.dmgY0 = oy0; s.dmgX1 = ox1; s.dmgY1 = oy1;
+        } else {
+            s.dmgX0 = std::min<int32_t>(s.dmgX0, ox0);
+            s.dmgY0 = std::min<int32_t>(s.dmgY0, oy0);
+            s.dmgX1 = std::max<int32_t>(s.dmgX1, ox1);
+            s.dmgY1 = std::max<int32_t>(s.dmgY1, oy1);
+        }
+
+        if (oy0 > cy)      drawAround(gfx, e, i + 1, cx, cy, cw, oy0 - cy);
+        if (oy1 < cy + ch) drawAround(gfx, e, i + 1, cx, oy1, cw, cy + ch - oy1);
+        if (ox0 > cx)      drawAround(gfx, e, i + 1, cx, oy0, ox0 - cx, oy1 - oy0);
+        if (ox1 < cx + cw) drawAround(gfx, e, i + 1, ox1, oy0, cx + cw - ox1, oy1 - oy0);
+        return;
+    }
+    gfx.setClipRect(cx, cy, cw, ch);
+    e->draw(gfx);
+}
+#endif
+
+// Draw one element.  Every widget draw goes through here so that content
+// beneath an open overlay never paints over it (see save-under above).
+static void drawElement(LovyanGFX& gfx, UIElement* e) {
+    TraceScope trace(TraceCat::DRAW, "draw", e->getTag());
+    RedrawScope region(gfx, e->getX(), e->getY(), e->getWidth(), e->getHeight());
+    OverdrawScope overdraw(gfx, e);
+    PanelWriteScope written(gfx);
+#if TAB5_STATS
+    StatsDrawScope stats(gfx, e);
+#endif
+#if TAB5_SAVE_UNDER
+    // Overlays are only on the panel; an off-screen canvas may not even be
+    // in screen coordinates (see UITabView::beginTransition())
+    for (auto& s : _saveUnders) {
+        if (&gfx != _latency.panel) break;
+        if (!occludes(s, e)) continue;
+        if (!rectsOverlap(e->getX(), e->getY(), e->getWidth(), e->getHeight(),
+                          s.x, s.y, s.w, s.h)) continue;
+
+        // Overlaps an open overlay — draw around it, then restore the clip
+        int32_t px, py, pw, ph;
+        gfx.getClipRect(&px, &py, &pw, &ph);
+        int32_t cx0 = std::max<int32_t>(px, e->getX());
+        int32_t cy0 = std::max<int32_t>(py, e->getY());
+        int32_t cx1 = std::min<int32_t>(px + pw, e->getX() + e->getWidth());
+        int32_t cy1 = std::min<int32_t>(py + ph, e->getY() + e->getHeight());
+        if (cx1 > cx0 && cy1 > cy0) {
+            drawAround(gfx, e, 0, cx0, cy0, cx1 - cx0, cy1 - cy0);
+        }
+        gfx.setClipRect(px, py, pw, ph);
+        return;
+    }
+#endif
+    e->draw(gfx);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Redraw scheduling (see UIManager::setFrameBudget)
+// ─────────────────────────────────────────────────────────────────────────────
+// While UIManager::drawDirty() runs, leaves that should wait are left dirty
+// (their container re-flagged) so a later tier or the next pass picks
+// them up.
+struct ScheduleState {
+    bool             active   = false;
+    uint8_t          tier     = 0;        // RedrawPriority being drawn
+    uint32_t         t0       = 0;
+    uint32_t         budgetUs = 0;
+    const UIElement* interactive = nullptr;   // Never held back
+    bool             backgroundWaiting = false;
+    int              carried  = 0;
+};
+static ScheduleState _schedule;
+
+static bool scheduleDefers(const UIElement* e) {
+    if (!_schedule.active || e == _schedule.interactive) return false;
+    RedrawPriority p = e->getRedrawPriority();
+    if (p <= RedrawPriority::OVERLAY) return false;
+    bool backgroundTier = _schedule.tier == (uint8_t)RedrawPriority::BACKGROUND;
+    if ((p == RedrawPriority::BACKGROUND) != backgroundTier) {
+        // Not this tier's: background waits for its tier, and content
+        // still dirty in the background tier was already held back
+        if (!backgroundTier) _schedule.backgroundWaiting = true;
+        return true;
+    }
+    if (_schedule.budgetUs && micros() - _schedule.t0 >= _schedule.budgetUs) {
+        _schedule.carried++;
+        return true;
+    }
+    return false;
+}
+
 // ═════════════════════════════════════════════════════════════════════════════
 //  UIElement — Base class
 // ═════════════════════════════════════════════════════════════════════════════
@@ -104,11 +1062,16 @@ UIElement::UIElement(int16_t x, int16_t y, int16_t w, int16_t h)
     : _x(x), _y(y), _w(w), _h(h) {}
 
 void UIElement::setPosition(int16_t x, int16_t y) {
-    _x = x; _y = y; _dirty = true;
+    _x = x; _y = y; invalidate();
 }
 
 void UIElement::setSize(int16_t w, int16_t h) {
-    _w = w; _h = h; _dirty = true;
+    _w = w; _h = h; invalidate();
+}
+
+void UIElement::setDirty(bool d) {
+    _dirty = d;
+    if (d && _parent) _parent->markChildDirty();
 }
 
 bool UIElement::hitTest(int16_t tx, int16_t ty) const {
@@ -120,18 +1083,31 @@ bool UIElement::hitTest(int16_t tx, int16_t ty) const {
 void UIElement::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIElement::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
+void UIElement::memoryInfo(UIMemoryInfo& m) const {
+    m.type = "UIElement";
+    m.objectBytes = sizeof(*this);
+}
+
+// Add an owned sprite: the M5Canvas object on the heap, its RGB565 pixels
+// in PSRAM
+static void canvasMemory(UIMemoryInfo& m, const M5Canvas* c) {
+    if (!c) return;
+    m.heapBytes  += sizeof(M5Canvas);
+    m.psramBytes += (size_t)c->width() * c->height() * 2;
+}
+
 // ═════════════════════════════════════════════════════════════════════════════
 //  UILabel
 // ═════════════════════════════════════════════════════════════════════════════
@@ -149,7 +1125,7 @@ UILabel::UILabel(int16_t x, int16_t y, int16_t w, int16_t h,
 void UILabel::setText(const char* text) {
     strncpy(_text, text, sizeof(_text) - 1);
     _text[sizeof(_text) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UILabel::draw(LovyanGFX& gfx) {
@@ -199,7 +1175,7 @@ UIButton::UIButton(int16_t x, int16_t y, int16_t w, int16_t h,
 void UIButton::setLabel(const char* label) {
     strncpy(_label, label, sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIButton::draw(LovyanGFX& gfx) {
@@ -233,15 +1209,15 @@ void UIButton::draw(LovyanGFX& gfx) {
 void UIButton::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIButton::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -268,7 +1244,7 @@ UIIconButton::UIIconButton(int16_t x, int16_t y, int16_t w, int16_t h,
 void UIIconButton::setLabel(const char* label) {
     strncpy(_label, label, sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIIconButton::draw(LovyanGFX& gfx) {
@@ -293,7 +1269,7 @@ void UIIconButton::draw(LovyanGFX& gfx) {
         // Center the 32×32 icon in the button
         int16_t ix = _x + (_w - 32) / 2;
         int16_t iy = _y + (_h - 32) / 2;
-        gfx.drawPng(_iconData, _iconSize, ix, iy, 32, 32);
+        drawIcon(gfx, _iconData, _iconSize, ix, iy, 32, 32, bg);
     } else {
         // Text fallback (same as UIButton)
         gfx.setTextSize(_textSize);
@@ -309,15 +1285,15 @@ void UIIconButton::draw(LovyanGFX& gfx) {
 void UIIconButton::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIIconButton::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -345,7 +1321,7 @@ void UISlider::setValue(int v) {
     if (v > _maxVal) v = _maxVal;
     if (v != _value) {
         _value = v;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -354,13 +1330,13 @@ void UISlider::setRange(int minVal, int maxVal) {
     _maxVal = maxVal;
     if (_value < _minVal) _value = _minVal;
     if (_value > _maxVal) _value = _maxVal;
-    _dirty = true;
+    setDirty();
 }
 
 void UISlider::setLabel(const char* label) {
     strncpy(_label, label, sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UISlider::_updateFromTouch(int16_t tx) {
@@ -383,8 +1359,8 @@ void UISlider::_updateFromTouch(int16_t tx) {
 
     if (newVal != _value) {
         _value = newVal;
-        _dirty = true;
-        if (_onChange) _onChange(_value);
+        setDirty();
+        fireCallback(this, "onChange", _onChange, _value);
     }
 }
 
@@ -462,7 +1438,7 @@ void UISlider::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -473,7 +1449,7 @@ void UISlider::handleTouchDown(int16_t tx, int16_t ty) {
     _dragging = true;
     _pressed = true;
     _updateFromTouch(tx);
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UISlider::handleTouchMove(int16_t tx, int16_t ty) {
@@ -486,8 +1462,8 @@ void UISlider::handleTouchUp(int16_t tx, int16_t ty) {
     if (_dragging) {
         _dragging = false;
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -509,19 +1485,19 @@ UITitleBar::UITitleBar(const char* title, uint32_t bgColor, uint32_t textColor)
 void UITitleBar::setTitle(const char* title) {
     strncpy(_title, title, sizeof(_title) - 1);
     _title[sizeof(_title) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITitleBar::setLeftText(const char* text) {
     strncpy(_leftText, text, sizeof(_leftText) - 1);
     _leftText[sizeof(_leftText) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITitleBar::setRightText(const char* text) {
     strncpy(_rightText, text, sizeof(_rightText) - 1);
     _rightText[sizeof(_rightText) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITitleBar::draw(LovyanGFX& gfx) {
@@ -569,38 +1545,38 @@ void UITitleBar::handleTouchDown(int16_t tx, int16_t ty) {
     // Check left zone
     if (_leftText[0] != '\0' && tx < ZONE_W) {
         _leftPressed = true;
-        _dirty = true;
-        if (_onLeftTouch) _onLeftTouch(TouchEvent::TOUCH);
+        setDirty();
+        fireCallback(this, "onLeftTouch", _onLeftTouch, TouchEvent::TOUCH);
         return;
     }
     // Check right zone
     if (_rightText[0] != '\0' && tx > (_w - ZONE_W)) {
         _rightPressed = true;
-        _dirty = true;
-        if (_onRightTouch) _onRightTouch(TouchEvent::TOUCH);
+        setDirty();
+        fireCallback(this, "onRightTouch", _onRightTouch, TouchEvent::TOUCH);
         return;
     }
 
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UITitleBar::handleTouchUp(int16_t tx, int16_t ty) {
     if (_leftPressed) {
         _leftPressed = false;
-        _dirty = true;
-        if (_onLeftTouch) _onLeftTouch(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onLeftTouch", _onLeftTouch, TouchEvent::TOUCH_RELEASE);
     }
     if (_rightPressed) {
         _rightPressed = false;
-        _dirty = true;
-        if (_onRightTouch) _onRightTouch(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRightTouch", _onRightTouch, TouchEvent::TOUCH_RELEASE);
     }
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -622,19 +1598,19 @@ UIStatusBar::UIStatusBar(const char* text, uint32_t bgColor, uint32_t textColor)
 void UIStatusBar::setText(const char* text) {
     strncpy(_text, text, sizeof(_text) - 1);
     _text[sizeof(_text) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIStatusBar::setLeftText(const char* text) {
     strncpy(_leftText, text, sizeof(_leftText) - 1);
     _leftText[sizeof(_leftText) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIStatusBar::setRightText(const char* text) {
     strncpy(_rightText, text, sizeof(_rightText) - 1);
     _rightText[sizeof(_rightText) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIStatusBar::draw(LovyanGFX& gfx) {
@@ -695,13 +1671,13 @@ UITextRow::UITextRow(int16_t x, int16_t y, int16_t w,
 void UITextRow::setLabel(const char* label) {
     strncpy(_label, label, sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITextRow::setValue(const char* value) {
     strncpy(_value, value, sizeof(_value) - 1);
     _value[sizeof(_value) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITextRow::draw(LovyanGFX& gfx) {
@@ -770,15 +1746,15 @@ void UIIconSquare::draw(LovyanGFX& gfx) {
 void UIIconSquare::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIIconSquare::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -832,15 +1808,15 @@ void UIIconCircle::draw(LovyanGFX& gfx) {
 void UIIconCircle::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTestCircle(tx, ty)) return;
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIIconCircle::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -878,7 +1854,7 @@ int UIMenu::addItem(const char* label, TouchCallback onSelect) {
     item.onSelect  = onSelect;
     _itemCount++;
     recalcHeight();
-    _dirty = true;
+    setDirty();
     return _itemCount - 1;
 }
 
@@ -891,20 +1867,20 @@ void UIMenu::addSeparator() {
     item.onSelect  = nullptr;
     _itemCount++;
     recalcHeight();
-    _dirty = true;
+    setDirty();
 }
 
 void UIMenu::clearItems() {
     _itemCount = 0;
     _pressedIndex = -1;
     recalcHeight();
-    _dirty = true;
+    setDirty();
 }
 
 void UIMenu::setItemEnabled(int index, bool enabled) {
     if (index >= 0 && index < _itemCount) {
         _items[index].enabled = enabled;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -912,20 +1888,20 @@ void UIMenu::setItemLabel(int index, const char* label) {
     if (index >= 0 && index < _itemCount) {
         strncpy(_items[index].label, label, sizeof(_items[index].label) - 1);
         _items[index].label[sizeof(_items[index].label) - 1] = '\0';
-        _dirty = true;
+        setDirty();
     }
 }
 
 void UIMenu::show() {
     _visible = true;
     _pressedIndex = -1;
-    _dirty = true;
+    setDirty();
 }
 
 void UIMenu::hide() {
     _visible = false;
     _pressedIndex = -1;
-    _dirty = true;
+    setDirty();
 }
 
 int UIMenu::itemIndexAt(int16_t tx, int16_t ty) const {
@@ -946,6 +1922,9 @@ int UIMenu::itemIndexAt(int16_t tx, int16_t ty) const {
 void UIMenu::draw(LovyanGFX& gfx) {
     if (!_visible) return;
 
+    // Snapshot what's beneath before the first paint (menu + shadow)
+    saveUnderCapture(gfx, this, _x, _y, _w + 3, _h + 3);
+
     // Sprite covers menu + shadow (shadow offset +3,+3)
     int16_t sprW = _w + 3;
     int16_t sprH = _h + 3;
@@ -1006,7 +1985,7 @@ void UIMenu::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -1018,7 +1997,7 @@ void UIMenu::handleTouchDown(int16_t tx, int16_t ty) {
     int idx = itemIndexAt(tx, ty);
     if (idx >= 0 && _items[idx].enabled) {
         _pressedIndex = idx;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -1036,12 +2015,12 @@ void UIMenu::handleTouchUp(int16_t tx, int16_t ty) {
             hide();  // auto-close after selection
         } else {
             _pressedIndex = -1;
-            _dirty = true;
+            setDirty();
         }
     } else {
         // Touch outside — dismiss
         hide();
-        if (_onDismiss) _onDismiss(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onDismiss", _onDismiss, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -1067,6 +2046,18 @@ UIKeyboard::UIKeyboard()
     setLayer(LOWER);
 }
 
+UIKeyboard::~UIKeyboard() {
+    freeLayerCache();
+}
+
+void UIKeyboard::memoryInfo(UIMemoryInfo& m) const {
+    m.type = "UIKeyboard";
+    m.objectBytes = sizeof(*this);
+    for (auto& layer : _layerCache) {
+        for (const M5Canvas* c : layer) canvasMemory(m, c);
+    }
+}
+
 void UIKeyboard::buildRow(UIKey* dst, int& count, const char* chars, int len) {
     count = len;
     for (int i = 0; i < len; ++i) {
@@ -1179,7 +2170,7 @@ void UIKeyboard::setLayer(Layer layer) {
         case SYMBOLS: _keys = _keysSymbols; _cols = _colsSymbols; break;
         default:      _keys = _keysLower;   _cols = _colsLower;   break;
     }
-    _dirty = true;
+    setDirty();
 }
 
 void UIKeyboard::show() {
@@ -1190,14 +2181,14 @@ void UIKeyboard::show() {
     _pressedRow = -1;
     _pressedCol = -1;
     setLayer(LOWER);
-    _dirty = true;
+    setDirty();
 }
 
 void UIKeyboard::hide() {
     _visible = false;
     _pressedRow = -1;
     _pressedCol = -1;
-    _dirty = true;
+    setDirty();
 }
 
 void UIKeyboard::keyRect(int row, int col,
@@ -1246,7 +2237,21 @@ void UIKeyboard::drawKey(LovyanGFX& gfx, int row, int col, bool pressed) {
 
     int16_t kx, ky, kw, kh;
     keyRect(row, col, kx, ky, kw, kh);
+    RedrawScope region(gfx, kx, ky, kw, kh);
+
+    // Blit the cell from the pre-rendered layer when there is one.  The
+    // pressed variant is built by handleTouchDown(), after the first press
+    // has been drawn directly.
+    if (M5Canvas* bmp = layerBitmap(gfx, _layer, pressed, !pressed)) {
+        int32_t px, py, pw, ph;
+        gfx.getClipRect(&px, &py, &pw, &ph);
+        gfx.setClipRect(kx, ky, kw, kh);
+        pushTraced(bmp, gfx, _x, _y);
+        gfx.setClipRect(px, py, pw, ph);
+        return;
+    }
 
+    overdrawRecord(gfx, kx, ky, kw, kh);   // (the blit above counts itself)
     const UIKey& key = _keys[row][col];
     uint32_t bg = pressed
                 ? rgb888(darken(key.bgColor, 30))
@@ -1259,6 +2264,7 @@ void UIKeyboard::drawKey(LovyanGFX& gfx, int row, int col, bool pressed) {
     gfx.setTextColor(rgb888(_textColor));
     gfx.drawString(key.label, kx + kw / 2, ky + kh / 2);
     gfx.endWrite();
+    notePanelWrite(gfx);
 }
 
 void UIKeyboard::draw(LovyanGFX& gfx) {
@@ -1267,12 +2273,30 @@ void UIKeyboard::draw(LovyanGFX& gfx) {
     // Cache display pointer so touch handlers can do single-key redraws
     _lastDisplay = &gfx;
 
+    saveUnderCapture(gfx, this, _x, _y, _w, _h);
+
+    // ── Pre-rendered layer: the whole keyboard is one blit ──
+    if (M5Canvas* bmp = layerBitmap(gfx, _layer, false)) {
+        pushTraced(bmp, gfx, _x, _y);
+        if (_pressedRow >= 0) drawKey(gfx, _pressedRow, _pressedCol, true);
+        _dirty = false;
+        return;
+    }
+
     // ── Try sprite-buffered rendering for flicker-free key presses ──
     M5Canvas* spr = acquireSprite(&gfx, _w, _h);
     LovyanGFX& dst = spr ? (LovyanGFX&)*spr : gfx;
-    int16_t ox = spr ? 0 : _x;
-    int16_t oy = spr ? 0 : _y;
+    renderKeys(dst, spr ? 0 : _x, spr ? 0 : _y, false);
+
+    // Push sprite to display in one transfer (flicker-free)
+    if (spr) {
+        pushTraced(spr, gfx, _x, _y);
+    }
+
+    _dirty = false;
+}
 
+void UIKeyboard::renderKeys(LovyanGFX& dst, int16_t ox, int16_t oy, bool allPressed) {
     // Background panel
     dst.fillRect(ox, oy, _w, _h, rgb888(_bgColor));
     // Top border
@@ -1283,11 +2307,12 @@ void UIKeyboard::draw(LovyanGFX& gfx) {
         for (int c = 0; c < _cols[r]; ++c) {
             int16_t kx, ky, kw, kh;
             keyRect(r, c, kx, ky, kw, kh);
-            // Offset into sprite coordinates
-            if (spr) { kx -= _x; ky -= _y; }
+            // Offset into destination coordinates
+            kx += ox - _x;
+            ky += oy - _y;
 
             const UIKey& key = _keys[r][c];
-            bool isPressed = (r == _pressedRow && c == _pressedCol);
+            bool isPressed = allPressed || (r == _pressedRow && c == _pressedCol);
 
             uint32_t bg = isPressed
                         ? rgb888(darken(key.bgColor, 30))
@@ -1302,13 +2327,68 @@ void UIKeyboard::draw(LovyanGFX& gfx) {
             dst.drawString(key.label, kx + kw / 2, ky + kh / 2);
         }
     }
+}
 
-    // Push sprite to display in one transfer (flicker-free)
-    if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+// ─── Pre-rendered layers ─────────────────────────────────────────────────────
+
+void UIKeyboard::setLayerCache(bool enable) {
+#if TAB5_RENDER_MODE != 2
+    _layerCacheOn = enable;
+    if (!enable) freeLayerCache();
+#else
+    (void)enable;
+#endif
+}
+
+void UIKeyboard::freeLayerCache() {
+    for (auto& variants : _layerCache) {
+        for (auto*& bmp : variants) {
+            if (!bmp) continue;
+            bmp->deleteSprite();
+            delete bmp;
+            bmp = nullptr;
+        }
     }
+}
 
-    _dirty = false;
+M5Canvas* UIKeyboard::layerBitmap(LovyanGFX& gfx, Layer layer, bool pressed, bool build) {
+    if (!_layerCacheOn) return nullptr;
+    M5Canvas*& bmp = _layerCache[layer][pressed ? 1 : 0];
+
+    // Rebuilt when the keyboard is resized (e.g. after a rotation)
+    if (bmp && (bmp->width() != _w || bmp->height() != _h)) {
+        bmp->deleteSprite();
+        delete bmp;
+        bmp = nullptr;
+    }
+    if (bmp || !build) return bmp;
+
+    bmp = new (std::nothrow) M5Canvas(&gfx);
+    if (!bmp) return nullptr;
+    bmp->setColorDepth(16);
+    bmp->setPsram(true);
+    if (!bmp->createSprite(_w, _h)) {
+        delete bmp;
+        bmp = nullptr;
+        return nullptr;
+    }
+    bmp->setFont(gfx.getFont());
+
+    // Render with the requested layer's tables, without touching _dirty
+    UIKey (*keys)[TAB5_KB_MAX_COLS] = _keys;
+    int* cols = _cols;
+    switch (layer) {
+        case UPPER:   _keys = _keysUpper;   _cols = _colsUpper;   break;
+        case SYMBOLS: _keys = _keysSymbols; _cols = _colsSymbols; break;
+        default:      _keys = _keysLower;   _cols = _colsLower;   break;
+    }
+    int pr = _pressedRow;
+    _pressedRow = -1;
+    renderKeys(*bmp, 0, 0, pressed);
+    _pressedRow = pr;
+    _keys = keys;
+    _cols = cols;
+    return bmp;
 }
 
 void UIKeyboard::handleTouchDown(int16_t tx, int16_t ty) {
@@ -1319,7 +2399,12 @@ void UIKeyboard::handleTouchDown(int16_t tx, int16_t ty) {
         _pressedRow = row;
         _pressedCol = col;
         // Draw only the pressed key highlight directly — no full redraw
-        if (_lastDisplay) drawKey(*_lastDisplay, row, col, true);
+        if (_lastDisplay) {
+            drawKey(*_lastDisplay, row, col, true);
+            // Once the highlight is up, render this layer's pressed variant
+            // so later presses are a blit
+            layerBitmap(*_lastDisplay, _layer, true);
+        }
     }
 }
 
@@ -1336,8 +2421,11 @@ void UIKeyboard::handleTouchUp(int16_t tx, int16_t ty) {
         const UIKey& key = _keys[row][col];
 
         if (key.value != 0) {
-            // Regular character or special (backspace, enter, done)
-            if (_onKey) _onKey(key.value);
+            // Regular character or special (backspace, enter, done).  The
+            // focused field's hook is never deferred: Enter / Done hide the
+            // keyboard, and update() must see that before it draws.
+            if (_inputHook) runCallback(this, "onKey", _inputHook, key.value);
+            fireCallback(this, "onKey", _onKey, key.value);
 
             // After typing a letter in UPPER mode, revert to LOWER
             if (_layer == UPPER && key.value >= 'A' && key.value <= 'Z') {
@@ -1385,27 +2473,27 @@ void UITextInput::setText(const char* text) {
     strncpy(_text, text, _maxLen);
     _text[_maxLen] = '\0';
     _cursorPos = (int)strlen(_text);
-    _dirty = true;
+    setDirty();
 }
 
 void UITextInput::clear() {
     _text[0] = '\0';
     _cursorPos = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UITextInput::setPlaceholder(const char* ph) {
     strncpy(_placeholder, ph, sizeof(_placeholder) - 1);
     _placeholder[sizeof(_placeholder) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITextInput::focus() {
     if (_focused) return;
     _focused = true;
-    _dirty = true;
+    setDirty();
     if (_keyboard) {
-        _keyboard->setOnKey([this](char ch) { this->onKeyPress(ch); });
+        _keyboard->_inputHook = [this](char ch) { this->onKeyPress(ch); };
         _keyboard->show();
     }
 }
@@ -1413,7 +2501,7 @@ void UITextInput::focus() {
 void UITextInput::blur() {
     if (!_focused) return;
     _focused = false;
-    _dirty = true;
+    setDirty();
     if (_keyboard && _keyboard->isOpen()) {
         _keyboard->hide();
     }
@@ -1432,7 +2520,7 @@ void UITextInput::onKeyPress(char ch) {
     }
     if (ch == '\n') {
         // Done key — submit and hide
-        if (_onSubmit) _onSubmit(_text);
+        fireCallback(this, "onSubmit", _onSubmit, _text);
         blur();
         return;
     }
@@ -1441,8 +2529,8 @@ void UITextInput::onKeyPress(char ch) {
         if (_cursorPos > 0) {
             _cursorPos--;
             _text[_cursorPos] = '\0';
-            _dirty = true;
-            if (_onChange) _onChange(_text);
+            setDirty();
+            fireCallback(this, "onChange", _onChange, _text);
         }
         return;
     }
@@ -1451,8 +2539,8 @@ void UITextInput::onKeyPress(char ch) {
         _text[_cursorPos] = ch;
         _cursorPos++;
         _text[_cursorPos] = '\0';
-        _dirty = true;
-        if (_onChange) _onChange(_text);
+        setDirty();
+        fireCallback(this, "onChange", _onChange, _text);
     }
 }
 
@@ -1503,151 +2591,684 @@ void UITextInput::draw(LovyanGFX& gfx) {
 void UITextInput::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
     _pressed = true;
-    _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UITextInput::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
-        _dirty = true;
+        setDirty();
         focus();  // Open keyboard on tap
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-//  UITabView
+//  UIContainer
 // ═════════════════════════════════════════════════════════════════════════════
 
-UITabView::UITabView(int16_t x, int16_t y, int16_t w, int16_t h,
-                     TabPosition pos, uint32_t barColor,
-                     uint32_t activeColor, uint32_t textColor)
-    : UIElement(x, y, w, h)
-    , _tabPos(pos)
-    , _barColor(barColor)
-    , _activeColor(activeColor)
-    , _textColor(textColor)
-{}
+UIContainer::UIContainer(int16_t x, int16_t y, int16_t w, int16_t h)
+    : UIElement(x, y, w, h) {}
 
-int UITabView::addPage(const char* label) {
-    if (_pageCount >= TAB5_TAB_MAX_PAGES) return -1;
-    int idx = _pageCount++;
-    strncpy(_pages[idx].label, label, 31);
-    _pages[idx].label[31] = '\0';
-    _pages[idx].childCount = 0;
-    _dirty = true;
-    return idx;
+void UIContainer::addChild(UIElement* child) {
+    if (!child) return;
+    if (child->_parent) child->_parent->removeChild(child);
+    _children.push_back(child);
+    child->_parent = this;
+    child->setDirty();
 }
 
-void UITabView::addChild(int pageIndex, UIElement* child) {
-    if (pageIndex < 0 || pageIndex >= _pageCount) return;
-    UITabPage& page = _pages[pageIndex];
-    if (page.childCount >= TAB5_TAB_MAX_CHILDREN) return;
-    page.children[page.childCount++] = child;
-    _dirty = true;
+void UIContainer::removeChild(UIElement* child) {
+    auto it = std::find(_children.begin(), _children.end(), child);
+    if (it == _children.end()) return;
+    _children.erase(it);
+    child->_parent = nullptr;
+    if (_touchedChild == child) _touchedChild = nullptr;
+    setDirty();
 }
 
-void UITabView::removeChild(int pageIndex, UIElement* child) {
-    if (pageIndex < 0 || pageIndex >= _pageCount) return;
-    UITabPage& page = _pages[pageIndex];
-    for (int i = 0; i < page.childCount; i++) {
-        if (page.children[i] == child) {
-            // Shift remaining children down
-            for (int j = i; j < page.childCount - 1; j++) {
-                page.children[j] = page.children[j + 1];
+void UIContainer::memoryInfo(UIMemoryInfo& m) const {
+    m.type = "UIContainer";
+    m.objectBytes = sizeof(*this);
+    m.heapBytes += _children.capacity() * sizeof(UIElement*);
+}
+
+void UIContainer::clearChildren() {
+    for (auto* child : _children) child->_parent = nullptr;
+    _children.clear();
+    _touchedChild = nullptr;
+    setDirty();
+}
+
+void UIContainer::markChildDirty() {
+    // Walk the whole chain rather than stopping at the first flagged
+    // ancestor: hidden subtrees (inactive tab pages) keep their flag across
+    // draw passes, so an early stop could miss a visible ancestor.  Real
+    // trees are 2–3 levels deep, so this stays effectively O(1).
+    for (UIContainer* c = this; c; c = c->_parent) {
+        c->_childDirty = true;
+    }
+}
+
+void UIContainer::childArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+    x = _x; y = _y; w = _w; h = _h;
+}
+
+void UIContainer::drawChildren(LovyanGFX& gfx, bool dirtyOnly) {
+    // Intersect the child area with the caller's clip so nested containers
+    // never draw outside any ancestor, then restore it for the caller.
+    int32_t px, py, pw, ph;
+    gfx.getClipRect(&px, &py, &pw, &ph);
+
+    int16_t ax, ay, aw, ah;
+    childArea(ax, ay, aw, ah);
+    int32_t cx0 = std::max<int32_t>(px, ax);
+    int32_t cy0 = std::max<int32_t>(py, ay);
+    int32_t cx1 = std::min<int32_t>(px + pw, ax + aw);
+    int32_t cy1 = std::min<int32_t>(py + ph, ay + ah);
+    if (cx1 <= cx0 || cy1 <= cy0) return;   // Entire subtree culled
+    int32_t cw = cx1 - cx0;
+    int32_t ch = cy1 - cy0;
+
+    gfx.setClipRect(cx0, cy0, cw, ch);
+    for (auto* child : _children) {
+        if (!child->isVisible()) continue;
+        // Bounding-box cull: skip children entirely outside the clip
+        if (!rectsOverlap(child->getX(), child->getY(),
+                          child->getWidth(), child->getHeight(),
+                          cx0, cy0, cw, ch)) continue;
+
+        if (!dirtyOnly || child->isDirty()) {
+            if (!dirtyOnly) child->_damaged = true;   // Background just cleared
+            if (dirtyOnly && scheduleDefers(child)) {
+                markChildDirty();   // Waits for a later tier or pass
+                continue;
             }
-            page.childCount--;
-            page.children[page.childCount] = nullptr;
-            _dirty = true;
-            return;
+            drawElement(gfx, child);
+            child->setDirty(false);
+        } else if (child->isContainer()) {
+            static_cast<UIContainer*>(child)->drawDirtyChildren(gfx);
         }
     }
+    gfx.setClipRect(px, py, pw, ph);
 }
 
-void UITabView::clearPage(int pageIndex) {
-    if (pageIndex < 0 || pageIndex >= _pageCount) return;
-    _pages[pageIndex].childCount = 0;
-    for (int i = 0; i < TAB5_TAB_MAX_CHILDREN; i++)
-        _pages[pageIndex].children[i] = nullptr;
-    _dirty = true;
-}
+void UIContainer::draw(LovyanGFX& gfx) {
+    if (!_visible) return;
 
-void UITabView::clearAllPages() {
-    for (int i = 0; i < _pageCount; i++) {
-        clearPage(i);
+    // Clear the flag first so children dirtied during their own draw()
+    // are picked up on the next pass.
+    _childDirty = false;
+
+    if (_hasBg) {
+        int16_t ax, ay, aw, ah;
+        childArea(ax, ay, aw, ah);
+        gfx.fillRect(ax, ay, aw, ah, rgb888(_bgColor));
     }
-    _pageCount = 0;
-    _activePage = 0;
-    _dirty = true;
-}
+    drawChildren(gfx, false);
 
-void UITabView::setActivePage(int index) {
-    if (index < 0 || index >= _pageCount || index == _activePage) return;
-    _activePage = index;
-    _touchedChild = nullptr;
-    _dirty = true;
-    if (_onTabChange) _onTabChange(index);
+    _dirty = false;
 }
 
-void UITabView::setPageLabel(int pageIndex, const char* label) {
-    if (pageIndex < 0 || pageIndex >= _pageCount) return;
-    strncpy(_pages[pageIndex].label, label, 31);
-    _pages[pageIndex].label[31] = '\0';
-    _dirty = true;
+void UIContainer::drawDirtyChildren(LovyanGFX& gfx) {
+    if (!_visible || !_childDirty) return;
+    _childDirty = false;
+    drawChildren(gfx, true);
 }
 
-const char* UITabView::getPageLabel(int pageIndex) const {
-    if (pageIndex < 0 || pageIndex >= _pageCount) return "";
-    return _pages[pageIndex].label;
+void UIContainer::translate(int16_t dx, int16_t dy) {
+    _x += dx;
+    _y += dy;
+    for (auto* child : _children) {
+        if (child->isContainer()) {
+            static_cast<UIContainer*>(child)->translate(dx, dy);
+        } else {
+            child->_x += dx;
+            child->_y += dy;
+        }
+    }
 }
 
-int16_t UITabView::tabBarY() const {
-    if (_tabPos == TabPosition::TOP) {
-        return _y;
-    } else {
-        return _y + _h - _tabBarH;
+void UIContainer::invalidateRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 UIElement* except) {
+    for (auto* child : _children) {
+        if (child == except || !child->isVisible()) continue;
+        if (!rectsOverlap(child->getX(), child->getY(),
+                          child->getWidth(), child->getHeight(),
+                          x, y, w, h)) continue;
+        if (child->isContainer()) {
+            static_cast<UIContainer*>(child)->invalidateRect(x, y, w, h, except);
+        } else {
+            child->invalidate();
+        }
     }
 }
 
-int16_t UITabView::contentY() const {
-    if (_tabPos == TabPosition::TOP) {
-        return _y + _tabBarH;
+UIElement* UIContainer::findChildAt(int16_t tx, int16_t ty) const {
+    // Reverse iterate for z-order; containers that miss the point are
+    // skipped without visiting their subtree.
+    for (int i = (int)_children.size() - 1; i >= 0; --i) {
+        UIElement* child = _children[i];
+        if (!child->isVisible() || !child->isEnabled()) continue;
+
+        bool hit = child->isCircleIcon()
+                 ? static_cast<UIIconCircle*>(child)->hitTestCircle(tx, ty)
+                 : child->hitTest(tx, ty);
+        if (!hit) continue;
+
+        if (child->isContainer()) {
+            UIElement* inner = static_cast<UIContainer*>(child)->findChildAt(tx, ty);
+            return inner ? inner : child;
+        }
+        return child;
+    }
+    return nullptr;
+}
+
+UIElement* UIContainer::findOpenOverlay() const {
+    for (int i = (int)_children.size() - 1; i >= 0; --i) {
+        UIElement* child = _children[i];
+        if (!child->isVisible()) continue;
+        if (child->isMenu() || child->isPopup()) return child;
+        if (child->isContainer()) {
+            UIElement* inner = static_cast<UIContainer*>(child)->findOpenOverlay();
+            if (inner) return inner;
+        }
+    }
+    return nullptr;
+}
+
+void UIContainer::handleTouchDown(int16_t tx, int16_t ty) {
+    if (!hitTest(tx, ty)) return;
+
+    _pressed = true;
+    _touchedChild = nullptr;
+
+    // An open overlay (menu/dropdown/popup) anywhere in the subtree gets
+    // exclusive touch, the same rule UIManager applies at the top level.
+    UIElement* overlay = findOpenOverlay();
+    if (overlay) {
+        _touchedChild = overlay;
+        overlay->handleTouchDown(tx, ty);
+        return;
+    }
+
+    // Dispatch to the topmost direct child under the finger; nested
+    // containers continue the descent themselves.
+    for (int i = (int)_children.size() - 1; i >= 0; --i) {
+        UIElement* child = _children[i];
+        if (!child->isVisible() || !child->isEnabled()) continue;
+
+        bool hit = child->isCircleIcon()
+                 ? static_cast<UIIconCircle*>(child)->hitTestCircle(tx, ty)
+                 : child->hitTest(tx, ty);
+
+        if (hit) {
+            _touchedChild = child;
+            child->handleTouchDown(tx, ty);
+            return;
+        }
+    }
+
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
+}
+
+void UIContainer::handleTouchMove(int16_t tx, int16_t ty) {
+    if (_touchedChild) {
+        _touchedChild->handleTouchMove(tx, ty);
+        // NOTE: Do NOT mark the container dirty here.  Dirty children are
+        // repainted by drawDirtyChildren(), which skips the background
+        // clear; a full draw() would flash between the clear and the
+        // child's sprite push.
+    }
+}
+
+void UIContainer::handleTouchUp(int16_t tx, int16_t ty) {
+    if (_touchedChild) {
+        // Check if the child was a modal overlay before the touch-up
+        bool wasModal = (_touchedChild->isMenu() || _touchedChild->isPopup())
+                      && _touchedChild->isVisible();
+        _touchedChild->handleTouchUp(tx, ty);
+
+        // If an overlay just closed, repaint the children it was covering.
+        // Do NOT mark the container itself dirty — that triggers a full
+        // background clear.  The closing widget erases its own footprint
+        // (see UIDropdown::draw() _needsListErase path).  Overlays with a
+        // save-under buffer are restored by UIManager instead.
+        if (wasModal && !_touchedChild->isMenu() && !_touchedChild->isPopup()
+            && !hasSaveUnder(_touchedChild)) {
+            int16_t ax, ay, aw, ah;
+            childArea(ax, ay, aw, ah);
+            invalidateRect(ax, ay, aw, ah, _touchedChild);
+        }
+        _touchedChild = nullptr;
+    }
+    _pressed = false;
+    fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  UITabView
+// ═════════════════════════════════════════════════════════════════════════════
+
+UITabView::UITabView(int16_t x, int16_t y, int16_t w, int16_t h,
+                     TabPosition pos, uint32_t barColor,
+                     uint32_t activeColor, uint32_t textColor)
+    : UIContainer(x, y, w, h)
+    , _tabPos(pos)
+    , _barColor(barColor)
+    , _activeColor(activeColor)
+    , _textColor(textColor)
+{}
+
+UITabView::~UITabView() {
+    invalidatePageCache(-1);
+    freeTransitionBuffers();
+}
+
+void UITabView::memoryInfo(UIMemoryInfo& m) const {
+    UIContainer::memoryInfo(m);
+    m.type = "UITabView";
+    m.objectBytes = sizeof(*this);
+    for (int i = 0; i < _pageCount; i++) canvasMemory(m, _pages[i].cache);
+    canvasMemory(m, _transOut);
+    canvasMemory(m, _transIn);
+    canvasMemory(m, _transStrip);
+}
+
+int UITabView::addPage(const char* label) {
+    if (_pageCount >= TAB5_TAB_MAX_PAGES) return -1;
+    int idx = _pageCount++;
+    strncpy(_pages[idx].label, label, 31);
+    _pages[idx].label[31] = '\0';
+    _pages[idx].content.clearChildren();
+    _pages[idx].content.setVisible(idx == _activePage);
+    UIContainer::addChild(&_pages[idx].content);
+    layoutPages();
+    setDirty();
+    return idx;
+}
+
+void UITabView::addChild(int pageIndex, UIElement* child) {
+    if (pageIndex < 0 || pageIndex >= _pageCount) return;
+    _pages[pageIndex].content.addChild(child);
+    setDirty();
+}
+
+void UITabView::removeChild(int pageIndex, UIElement* child) {
+    if (pageIndex < 0 || pageIndex >= _pageCount) return;
+    _pages[pageIndex].content.removeChild(child);
+    setDirty();
+}
+
+void UITabView::clearPage(int pageIndex) {
+    if (pageIndex < 0 || pageIndex >= _pageCount) return;
+    _pages[pageIndex].content.clearChildren();
+    setDirty();
+}
+
+void UITabView::clearAllPages() {
+    for (int i = 0; i < _pageCount; i++) {
+        clearPage(i);
+    }
+    invalidatePageCache(-1);
+    UIContainer::clearChildren();
+    _pageCount = 0;
+    _activePage = 0;
+    setDirty();
+}
+
+void UITabView::setActivePage(int index) {
+    if (index < 0 || index >= _pageCount || index == _activePage) return;
+    if (_transActive) {
+        // Interrupted — the screen shows a mid-animation frame, which the
+        // next transition starts from but the page cache must not keep
+        _transActive = false;
+    } else if (_cacheBudget && _lastGfx && _pages[_activePage].cacheStale) {
+        // Snapshot the outgoing page while it is still on screen
+        capturePage(*_lastGfx, _activePage);
+    }
+    _transPending = _transition != TabTransition::NONE && _lastGfx &&
+                    captureOutgoing(*_lastGfx);
+    _transDir = (index > _activePage) ? 1 : -1;
+    _pages[_activePage].content.setVisible(false);
+    _pages[index].content.setVisible(true);
+    _activePage = index;
+    _touchedChild = nullptr;
+    setDirty();
+    fireCallback(this, "onTabChange", _onTabChange, index);
+}
+
+void UITabView::layoutPages() {
+    int16_t cy = contentY();
+    int16_t ch = contentH();
+    for (int i = 0; i < _pageCount; i++) {
+        UIContainer& c = _pages[i].content;
+        // Only touch changed geometry — setPosition()/setSize() mark dirty
+        if (c.getX() != _x || c.getY() != cy) c.setPosition(_x, cy);
+        if (c.getWidth() != _w || c.getHeight() != ch) c.setSize(_w, ch);
+    }
+}
+
+void UITabView::childArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+    x = _x; y = contentY(); w = _w; h = contentH();
+}
+
+// ─── Page cache ──────────────────────────────────────────────────────────────
+// A page's bitmap is captured as it is switched away from, and blitted when
+// it is shown again if its container hasn't been invalidated as a whole
+// (child added/removed, resized, recoloured).  Children that changed while
+// the page was hidden keep their dirty flag and are drawn over the blit.
+// Pages are stored uncompressed so a restore is one contiguous transfer.
+
+void UITabView::setPageCacheBudget(size_t bytes) {
+#if TAB5_RENDER_MODE != 2
+    _cacheBudget = bytes;
+    if (bytes == 0) {
+        invalidatePageCache(-1);
     } else {
-        return _y;
+        reservePageCache(0, -1);
     }
+#else
+    (void)bytes;
+#endif
 }
 
-int16_t UITabView::contentH() const {
-    return _h - _tabBarH;
+size_t UITabView::getPageCacheBytes() const {
+    size_t total = 0;
+    for (int i = 0; i < _pageCount; i++) {
+        const M5Canvas* c = _pages[i].cache;
+        if (c) total += (size_t)c->width() * c->height() * 2;
+    }
+    return total;
 }
 
-bool UITabView::hasActiveDirtyChild() const {
-    if (_activePage < 0 || _activePage >= _pageCount) return false;
-    const UITabPage& page = _pages[_activePage];
-    for (int i = 0; i < page.childCount; i++) {
-        if (page.children[i] && page.children[i]->isVisible() && page.children[i]->isDirty())
-            return true;
+void UITabView::invalidatePageCache(int pageIndex) {
+    for (int i = 0; i < TAB5_TAB_MAX_PAGES; i++) {
+        if (pageIndex >= 0 && i != pageIndex) continue;
+        UITabPage& p = _pages[i];
+        if (p.cache) {
+            p.cache->deleteSprite();
+            delete p.cache;
+            p.cache = nullptr;
+        }
+        p.cacheStale = true;
     }
-    return false;
 }
 
-void UITabView::drawDirtyChildren(LovyanGFX& gfx) {
-    if (!_visible || _activePage < 0 || _activePage >= _pageCount) return;
+bool UITabView::reservePageCache(size_t need, int keep) {
+    while (getPageCacheBytes() + need > _cacheBudget) {
+        int lru = -1;
+        for (int i = 0; i < _pageCount; i++) {
+            if (i == keep || !_pages[i].cache) continue;
+            if (lru < 0 || _pages[i].cacheStamp < _pages[lru].cacheStamp) lru = i;
+        }
+        if (lru < 0) return false;
+        invalidatePageCache(lru);
+    }
+    return true;
+}
 
+void UITabView::capturePage(LovyanGFX& gfx, int pageIndex) {
+#if TAB5_RENDER_MODE != 2
+    UITabPage& p = _pages[pageIndex];
     int16_t cy = contentY();
     int16_t ch = contentH();
+    if (_w <= 0 || ch <= 0) return;
+    if (_x < 0 || cy < 0 || _x + _w > Tab5UI::screenW() ||
+        cy + ch > Tab5UI::screenH()) return;
+    // Never cache an overlay along with the page
+    if (saveUnderOverlaps(_x, cy, _w, ch) || p.content.findOpenOverlay()) return;
+
+    if (p.cache && (p.cache->width() != _w || p.cache->height() != ch)) {
+        invalidatePageCache(pageIndex);
+    }
+    if (!p.cache) {
+        if (!reservePageCache((size_t)_w * ch * 2, pageIndex)) return;
+        p.cache = new (std::nothrow) M5Canvas(&gfx);
+        if (!p.cache) return;
+        p.cache->setColorDepth(16);
+        p.cache->setPsram(true);
+        if (!p.cache->createSprite(_w, ch)) {
+            delete p.cache;
+            p.cache = nullptr;
+            return;
+        }
+    }
+
+    // M5Canvas stores 16-bit pixels byte-swapped, so read them that way
+    gfx.readRect(_x, cy, _w, ch, (lgfx::swap565_t*)p.cache->getBuffer());
+    p.cacheStale = false;
+    p.cacheStamp = ++_cacheTick;
+#else
+    (void)gfx; (void)pageIndex;
+#endif
+}
+
+// Hidden pages move too, so they stay in place under the tab view
+void UITabView::translate(int16_t dx, int16_t dy) {
+    UIContainer::translate(dx, dy);
+    for (int i = 0; i < _pageCount; i++) _pages[i].content.translate(dx, dy);
+}
 
+bool UITabView::blitPage(LovyanGFX& gfx, int pageIndex, int16_t dx, int16_t dy) {
+    UITabPage& p = _pages[pageIndex];
+    if (!p.cache || p.cacheStale || p.content.isDirty()) return false;
+    int16_t cy = contentY();
+    int16_t ch = contentH();
+    if (p.cache->width() != _w || p.cache->height() != ch) return false;
+    // Drawn in bands around an overlay — fall back to a normal draw
+    if (saveUnderOverlaps(_x, cy, _w, ch)) return false;
+
+    pushTraced(p.cache, gfx, _x + dx, cy + dy);
+    p.cacheStamp = ++_cacheTick;
+    return true;
+}
+
+// ─── Page transitions ────────────────────────────────────────────────────────
+// setActivePage() reads the outgoing page back from the display.  The next
+// draw() renders the incoming page once into an off-screen canvas, then each
+// update() composites the two snapshots row by row into a small strip buffer
+// and pushes it.  No widget draws happen until the animation lands.
+
+static constexpr int16_t TRANSITION_STRIP_H = 16;
+
+// (Re)allocate a 16-bit PSRAM canvas of exactly w × h.  nullptr on failure.
+static M5Canvas* ensureCanvas(M5Canvas*& c, LovyanGFX& gfx, int16_t w, int16_t h) {
+    if (c && c->width() == w && c->height() == h) return c;
+    if (!c) {
+        c = new (std::nothrow) M5Canvas(&gfx);
+        if (!c) return nullptr;
+        c->setColorDepth(16);
+        c->setPsram(true);
+    }
+    c->deleteSprite();
+    if (!c->createSprite(w, h)) return nullptr;
+    return c;
+}
+
+// Blend two RGB565 pixels; alpha 0..32 weights b.  Canvas pixels are stored
+// byte-swapped, so swap in and out around the blend.
+static inline uint16_t blendSwapped565(uint16_t a, uint16_t b, uint32_t alpha) {
+    a = __builtin_bswap16(a);
+    b = __builtin_bswap16(b);
+    uint32_t x = (a | ((uint32_t)a << 16)) & 0x07E0F81F;
+    uint32_t y = (b | ((uint32_t)b << 16)) & 0x07E0F81F;
+    uint32_t r = ((((y - x) * alpha) >> 5) + x) & 0x07E0F81F;
+    return __builtin_bswap16((uint16_t)(r | (r >> 16)));
+}
+
+void UITabView::setTransition(TabTransition t, uint16_t durationMs) {
+#if TAB5_RENDER_MODE != 2
+    _transition = t;
+    _transMs = durationMs ? durationMs : 1;
+    if (t == TabTransition::NONE) {
+        _transActive = _transPending = false;
+        freeTransitionBuffers();
+    }
+#else
+    (void)t; (void)durationMs;
+#endif
+}
+
+void UITabView::freeTransitionBuffers() {
+    M5Canvas** bufs[] = { &_transOut, &_transIn, &_transStrip };
+    for (auto* b : bufs) {
+        if (!*b) continue;
+        (*b)->deleteSprite();
+        delete *b;
+        *b = nullptr;
+    }
+}
+
+bool UITabView::captureOutgoing(LovyanGFX& gfx) {
+    int16_t cy = contentY();
+    int16_t ch = contentH();
+    if (_w <= 0 || ch <= 0) return false;
+    if (_x < 0 || cy < 0 || _x + _w > Tab5UI::screenW() ||
+        cy + ch > Tab5UI::screenH()) return false;
+    if (saveUnderOverlaps(_x, cy, _w, ch)) return false;
+    if (!ensureCanvas(_transOut, gfx, _w, ch)) return false;
+
+    gfx.readRect(_x, cy, _w, ch, (lgfx::swap565_t*)_transOut->getBuffer());
+    return true;
+}
+
+bool UITabView::beginTransition(LovyanGFX& gfx) {
+    int16_t cy = contentY();
+    int16_t ch = contentH();
+    if (!_transOut || _transOut->width() != _w || _transOut->height() != ch) return false;
+    if (saveUnderOverlaps(_x, cy, _w, ch)) return false;
+    // The incoming canvas covers just the content area.  The page is moved
+    // to canvas coordinates for the one draw into it, then moved back.
+    if (!ensureCanvas(_transIn, gfx, _w, ch)) return false;
+    if (!ensureCanvas(_transStrip, gfx, _w, TRANSITION_STRIP_H)) return false;
+
+    M5Canvas& in = *_transIn;
+    in.setFont(gfx.getFont());
+    in.setClipRect(0, 0, _w, ch);
     UITabPage& page = _pages[_activePage];
+    page.content.translate(-_x, -cy);
+    if (blitPage(in, _activePage, -_x, -cy)) {
+        if (page.content.hasDirtyChild()) page.content.drawDirtyChildren(in);
+    } else {
+        page.content.draw(in);
+    }
+    page.content.translate(_x, cy);
+    page.content.setDirty(false);
+    page.cacheStale = true;
+
+    _transActive = true;
+    _transStart = uiMillis();
+    return true;
+}
+
+void UITabView::stepTransition(LovyanGFX& gfx) {
+    int16_t cy = contentY();
+    int16_t ch = contentH();
+    unsigned long elapsed = uiMillis() - _transStart;
+    if (elapsed >= _transMs || _transOut->width() != _w ||
+        _transOut->height() != ch || _transIn->width() != _w ||
+        _transIn->height() != ch) {
+        finishTransition(gfx);
+        return;
+    }
+
+    // Ease out (cubic) so the motion settles gently
+    float t = 1.0f - (float)elapsed / _transMs;
+    t = 1.0f - t * t * t;
+    int32_t  shift = (int32_t)(t * _w);
+    uint32_t alpha = (uint32_t)(t * 32);
+
+    const uint16_t* out = (const uint16_t*)_transOut->getBuffer();
+    const uint16_t* in  = (const uint16_t*)_transIn->getBuffer();
+    uint16_t* strip     = (uint16_t*)_transStrip->getBuffer();
+
+    int32_t px, py, pw, ph;
+    gfx.getClipRect(&px, &py, &pw, &ph);
     gfx.setClipRect(_x, cy, _w, ch);
-    for (int i = 0; i < page.childCount; i++) {
-        UIElement* child = page.children[i];
-        if (child && child->isVisible() && child->isDirty()) {
-            child->draw(gfx);
-            child->setDirty(false);
+    for (int16_t row = 0; row < ch; row += TRANSITION_STRIP_H) {
+        int16_t rows = std::min<int16_t>(TRANSITION_STRIP_H, ch - row);
+        for (int16_t r = 0; r < rows; r++) {
+            const uint16_t* o = out + (int32_t)(row + r) * _w;
+            const uint16_t* n = in + (int32_t)(row + r) * _w;
+            uint16_t* d = strip + (int32_t)r * _w;
+            if (_transition == TabTransition::FADE) {
+                for (int16_t c = 0; c < _w; c++) d[c] = blendSwapped565(o[c], n[c], alpha);
+            } else if (_transDir > 0) {
+                memcpy(d, o + shift, (_w - shift) * 2);
+                memcpy(d + _w - shift, n, shift * 2);
+            } else {
+                memcpy(d, n + _w - shift, shift * 2);
+                memcpy(d + shift, o, (_w - shift) * 2);
+            }
         }
+        // Rows past the content area (last strip) fall outside the clip
+        pushTraced(_transStrip, gfx, _x, cy + row);
     }
-    gfx.clearClipRect();
+    gfx.setClipRect(px, py, pw, ph);
+
+    // Ask for another frame on the next update()
+    markChildDirty();
+}
+
+void UITabView::finishTransition(LovyanGFX& gfx) {
+    _transActive = false;
+    int16_t cy = contentY();
+    int16_t ch = contentH();
+    UIContainer& content = _pages[_activePage].content;
+    if (_transIn->width() != _w || _transIn->height() != ch) {
+        // Resized mid-animation — the snapshot no longer fits
+        setDirty();
+        return;
+    }
+
+    int32_t px, py, pw, ph;
+    gfx.getClipRect(&px, &py, &pw, &ph);
+    gfx.setClipRect(_x, cy, _w, ch);
+    pushTraced(_transIn, gfx, _x, cy);
+    gfx.setClipRect(px, py, pw, ph);
+
+    // Children that changed during the animation
+    if (content.hasDirtyChild()) content.drawDirtyChildren(gfx);
+}
+
+void UITabView::setPageLabel(int pageIndex, const char* label) {
+    if (pageIndex < 0 || pageIndex >= _pageCount) return;
+    strncpy(_pages[pageIndex].label, label, 31);
+    _pages[pageIndex].label[31] = '\0';
+    setDirty();
+}
+
+const char* UITabView::getPageLabel(int pageIndex) const {
+    if (pageIndex < 0 || pageIndex >= _pageCount) return "";
+    return _pages[pageIndex].label;
+}
+
+int16_t UITabView::tabBarY() const {
+    if (_tabPos == TabPosition::TOP) {
+        return _y;
+    } else {
+        return _y + _h - _tabBarH;
+    }
+}
+
+int16_t UITabView::contentY() const {
+    if (_tabPos == TabPosition::TOP) {
+        return _y + _tabBarH;
+    } else {
+        return _y;
+    }
+}
+
+int16_t UITabView::contentH() const {
+    return _h - _tabBarH;
+}
+
+bool UITabView::hasActiveDirtyChild() const {
+    if (_activePage < 0 || _activePage >= _pageCount) return false;
+    return _pages[_activePage].content.hasDirtyChild();
 }
 
 bool UITabView::hitTestTabBar(int16_t tx, int16_t ty) const {
@@ -1717,124 +3338,77 @@ void UITabView::drawTabBar(LovyanGFX& gfx) {
 void UITabView::draw(LovyanGFX& gfx) {
     if (!_visible) return;
 
-    // Fill the content area background
-    int16_t cy = contentY();
-    int16_t ch = contentH();
-    gfx.fillRect(_x, cy, _w, ch, rgb888(Tab5Theme::BG_DARK));
+    // Pick up any geometry change made through setPosition()/setSize()
+    layoutPages();
 
     // Draw the tab bar
     drawTabBar(gfx);
 
-    // Draw active page's children
-    if (_activePage >= 0 && _activePage < _pageCount) {
+    if (_pageCount > 0) {
+        _lastGfx = &gfx;
         UITabPage& page = _pages[_activePage];
-        // Set clip to content area so children don't bleed into tab bar
-        gfx.setClipRect(_x, cy, _w, ch);
-        for (int i = 0; i < page.childCount; i++) {
-            if (page.children[i] && page.children[i]->isVisible()) {
-                page.children[i]->draw(gfx);
-                page.children[i]->setDirty(false);
+        if (_transPending) {
+            _transPending = false;
+            beginTransition(gfx);
+        }
+        if (_transActive) {
+            _childDirty = false;
+            stepTransition(gfx);
+            _dirty = false;
+            return;
+        }
+        if (blitPage(gfx, _activePage)) {
+            // Only children changed since the snapshot need drawing
+            _childDirty = false;
+            if (page.content.hasDirtyChild()) {
+                page.content.drawDirtyChildren(gfx);
+                page.cacheStale = true;
             }
+            _dirty = false;
+            return;
         }
-        gfx.clearClipRect();
+        page.cacheStale = true;
     }
 
-    _dirty = false;
+    // The active page container fills the content area background and
+    // draws its children clipped to it; inactive pages are hidden.
+    UIContainer::draw(gfx);
+}
+
+void UITabView::drawDirtyChildren(LovyanGFX& gfx) {
+    if (_transActive) {
+        // Children wait until the animation lands
+        if (!_visible) return;
+        _childDirty = false;
+        stepTransition(gfx);
+        return;
+    }
+    // Anything drawn on the active page makes its snapshot out of date
+    if (_visible && _pageCount > 0 &&
+        _pages[_activePage].content.hasDirtyChild()) {
+        _pages[_activePage].cacheStale = true;
+    }
+    UIContainer::drawDirtyChildren(gfx);
 }
 
 void UITabView::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
 
-    _pressed = true;
-    _touchedChild = nullptr;
-
-    // Check if any child on the active page is a modal overlay (menu/popup)
-    // If so, route ALL touch to it exclusively (same pattern as UIManager)
-    if (_activePage >= 0 && _activePage < _pageCount) {
-        UITabPage& page = _pages[_activePage];
-        for (int i = page.childCount - 1; i >= 0; --i) {
-            UIElement* child = page.children[i];
-            if (!child || !child->isVisible()) continue;
-            if (child->isMenu() || child->isPopup()) {
-                _touchedChild = child;
-                child->handleTouchDown(tx, ty);
-                return;
-            }
-        }
-    }
-
-    // Check if touch is on the tab bar
-    if (hitTestTabBar(tx, ty)) {
+    // An open overlay on the active page (menu/dropdown/popup) gets ALL
+    // touch, so only handle the tab bar when there is none.
+    if (!findOpenOverlay() && hitTestTabBar(tx, ty)) {
+        _pressed = true;
+        _touchedChild = nullptr;
         int idx = tabIndexAt(tx, ty);
         if (idx >= 0 && idx != _activePage) {
             setActivePage(idx);
         }
-        if (_onTouch) _onTouch(TouchEvent::TOUCH);
+        fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
         return;
     }
 
-    // Touch is in the content area — dispatch to active page's children
-    if (_activePage >= 0 && _activePage < _pageCount) {
-        UITabPage& page = _pages[_activePage];
-        // Reverse iterate for z-order
-        for (int i = page.childCount - 1; i >= 0; --i) {
-            UIElement* child = page.children[i];
-            if (!child || !child->isVisible() || !child->isEnabled()) continue;
-
-            bool hit = child->isCircleIcon()
-                     ? static_cast<UIIconCircle*>(child)->hitTestCircle(tx, ty)
-                     : child->hitTest(tx, ty);
-
-            if (hit) {
-                _touchedChild = child;
-                child->handleTouchDown(tx, ty);
-                return;
-            }
-        }
-    }
-
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
-}
-
-void UITabView::handleTouchMove(int16_t tx, int16_t ty) {
-    if (_touchedChild) {
-        _touchedChild->handleTouchMove(tx, ty);
-        // NOTE: Do NOT propagate child dirty → TabView dirty here.
-        // UIManager::drawDirty() already handles dirty children via
-        // drawDirtyChildren(), which skips the background clear.
-        // Propagating would force UITabView::draw() with its fillRect,
-        // causing a visible flash between the clear and the sprite push.
-    }
-}
-
-void UITabView::handleTouchUp(int16_t tx, int16_t ty) {
-    if (_touchedChild) {
-        // Check if the child was a modal overlay before the touch-up
-        bool wasModal = (_touchedChild->isMenu() || _touchedChild->isPopup())
-                      && _touchedChild->isVisible();
-        _touchedChild->handleTouchUp(tx, ty);
-
-        // If a modal child just closed (isMenu/isPopup went from true→false),
-        // mark overlapping siblings dirty so they repaint over the stale
-        // overlay area.  Do NOT mark the TabView itself dirty — that triggers
-        // UITabView::draw() with its full-content fillRect flash.  The
-        // closing widget is responsible for erasing its own overlay footprint
-        // (see UIDropdown::draw() _needsListErase path).
-        if (wasModal && !_touchedChild->isMenu() && !_touchedChild->isPopup()) {
-            if (_activePage >= 0 && _activePage < _pageCount) {
-                UITabPage& page = _pages[_activePage];
-                for (int i = 0; i < page.childCount; i++) {
-                    UIElement* sibling = page.children[i];
-                    if (sibling && sibling != _touchedChild && sibling->isVisible()) {
-                        sibling->setDirty(true);
-                    }
-                }
-            }
-        }
-        _touchedChild = nullptr;
-    }
-    _pressed = false;
-    if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+    // Content area — the active page container dispatches to its children
+    UIContainer::handleTouchDown(tx, ty);
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -1859,21 +3433,21 @@ void UIInfoPopup::setTitle(const char* title) {
     strncpy(_title, title, sizeof(_title) - 1);
     _title[sizeof(_title) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIInfoPopup::setMessage(const char* msg) {
     strncpy(_message, msg, sizeof(_message) - 1);
     _message[sizeof(_message) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIInfoPopup::setButtonLabel(const char* label) {
     strncpy(_btnLabel, label, sizeof(_btnLabel) - 1);
     _btnLabel[sizeof(_btnLabel) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIInfoPopup::show() {
@@ -1881,13 +3455,13 @@ void UIInfoPopup::show() {
     _visible = true;
     _btnPressed = false;
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIInfoPopup::hide() {
     _visible = false;
     _btnPressed = false;
-    _dirty = true;
+    setDirty();
 }
 
 bool UIInfoPopup::hitTestBtn(int16_t tx, int16_t ty) const {
@@ -2046,6 +3620,9 @@ void UIInfoPopup::draw(LovyanGFX& gfx) {
         autoSize(gfx);
     }
 
+    // Snapshot what's beneath before the first paint (popup + shadow)
+    saveUnderCapture(gfx, this, _x, _y, _w + 4, _h + 4);
+
     // Sprite covers popup + shadow (shadow is offset +4,+4)
     int16_t sprW = _w + 4;
     int16_t sprH = _h + 4;
@@ -2121,7 +3698,7 @@ void UIInfoPopup::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -2132,7 +3709,7 @@ void UIInfoPopup::handleTouchDown(int16_t tx, int16_t ty) {
 
     if (hitTestBtn(tx, ty)) {
         _btnPressed = true;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -2143,15 +3720,15 @@ void UIInfoPopup::handleTouchUp(int16_t tx, int16_t ty) {
         // OK button tapped
         _btnPressed = false;
         hide();
-        if (_onDismiss) _onDismiss(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onDismiss", _onDismiss, TouchEvent::TOUCH_RELEASE);
     } else if (!hitTest(tx, ty)) {
         // Tap outside popup — dismiss
         _btnPressed = false;
         hide();
-        if (_onDismiss) _onDismiss(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onDismiss", _onDismiss, TouchEvent::TOUCH_RELEASE);
     } else {
         _btnPressed = false;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -2180,28 +3757,28 @@ void UIConfirmPopup::setTitle(const char* title) {
     strncpy(_title, title, sizeof(_title) - 1);
     _title[sizeof(_title) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIConfirmPopup::setMessage(const char* msg) {
     strncpy(_message, msg, sizeof(_message) - 1);
     _message[sizeof(_message) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIConfirmPopup::setYesLabel(const char* label) {
     strncpy(_yesLabel, label, sizeof(_yesLabel) - 1);
     _yesLabel[sizeof(_yesLabel) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIConfirmPopup::setNoLabel(const char* label) {
     strncpy(_noLabel, label, sizeof(_noLabel) - 1);
     _noLabel[sizeof(_noLabel) - 1] = '\0';
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIConfirmPopup::show() {
@@ -2210,14 +3787,14 @@ void UIConfirmPopup::show() {
     _noBtnPressed = false;
     _result = ConfirmResult::NO;
     _needsAutoSize = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIConfirmPopup::hide() {
     _visible = false;
     _yesBtnPressed = false;
     _noBtnPressed = false;
-    _dirty = true;
+    setDirty();
 }
 
 bool UIConfirmPopup::hitTestYesBtn(int16_t tx, int16_t ty) const {
@@ -2369,6 +3946,8 @@ void UIConfirmPopup::draw(LovyanGFX& gfx) {
         autoSize(gfx);
     }
 
+    saveUnderCapture(gfx, this, _x, _y, _w + 4, _h + 4);
+
     // Sprite covers popup + shadow (shadow is offset +4,+4)
     int16_t sprW = _w + 4;
     int16_t sprH = _h + 4;
@@ -2469,7 +4048,7 @@ void UIConfirmPopup::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -2480,10 +4059,10 @@ void UIConfirmPopup::handleTouchDown(int16_t tx, int16_t ty) {
 
     if (hitTestYesBtn(tx, ty)) {
         _yesBtnPressed = true;
-        _dirty = true;
+        setDirty();
     } else if (hitTestNoBtn(tx, ty)) {
         _noBtnPressed = true;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -2495,24 +4074,24 @@ void UIConfirmPopup::handleTouchUp(int16_t tx, int16_t ty) {
         _yesBtnPressed = false;
         _result = ConfirmResult::YES;
         hide();
-        if (_onConfirm) _onConfirm(ConfirmResult::YES);
+        fireCallback(this, "onConfirm", _onConfirm, ConfirmResult::YES);
     } else if (_noBtnPressed && hitTestNoBtn(tx, ty)) {
         // No button tapped
         _noBtnPressed = false;
         _result = ConfirmResult::NO;
         hide();
-        if (_onConfirm) _onConfirm(ConfirmResult::NO);
+        fireCallback(this, "onConfirm", _onConfirm, ConfirmResult::NO);
     } else if (!hitTest(tx, ty)) {
         // Tap outside popup — treat as No
         _yesBtnPressed = false;
         _noBtnPressed = false;
         _result = ConfirmResult::NO;
         hide();
-        if (_onConfirm) _onConfirm(ConfirmResult::NO);
+        fireCallback(this, "onConfirm", _onConfirm, ConfirmResult::NO);
     } else {
         _yesBtnPressed = false;
         _noBtnPressed = false;
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -2533,18 +4112,18 @@ void UIScrollText::setText(const char* text) {
     _text[TAB5_SCROLLTEXT_MAX_LEN - 1] = '\0';
     _needsWrap = true;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollText::scrollTo(int16_t offset) {
     _scrollOffset = offset;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollText::scrollToBottom() {
     _scrollOffset = maxScroll();
-    _dirty = true;
+    setDirty();
 }
 
 int16_t UIScrollText::totalContentHeight() const {
@@ -2610,6 +4189,7 @@ int16_t UIScrollText::markdownTextWidth(LovyanGFX& gfx, const char* text, int le
 
 // ── Reflow: parse markdown blocks and word-wrap each paragraph ──
 void UIScrollText::reflow(LovyanGFX& gfx) {
+    TraceScope trace(TraceCat::REFLOW, "reflow", getTag(), strlen(_text));
     int16_t contentW = _w - TAB5_PADDING * 2 - TAB5_LIST_SCROLLBAR_W - 4;
     _lineCount = 0;
 
@@ -3016,7 +4596,7 @@ void UIScrollText::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -3030,7 +4610,7 @@ void UIScrollText::handleTouchDown(int16_t tx, int16_t ty) {
     _touchStartY = ty;
     _touchDownY = ty;
     _scrollStart = _scrollOffset;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIScrollText::handleTouchMove(int16_t tx, int16_t ty) {
@@ -3047,7 +4627,7 @@ void UIScrollText::handleTouchMove(int16_t tx, int16_t ty) {
     if (_wasDrag) {
         _scrollOffset = _scrollStart + dy;
         clampScroll();
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -3056,7 +4636,7 @@ void UIScrollText::handleTouchUp(int16_t tx, int16_t ty) {
     _pressed = false;
     _dragging = false;
     _wasDrag = false;
-    if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+    fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -3082,7 +4662,7 @@ UIScrollTextPopup::UIScrollTextPopup(const char* title, const char* content)
 void UIScrollTextPopup::setTitle(const char* title) {
     strncpy(_title, title, sizeof(_title) - 1);
     _title[sizeof(_title) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollTextPopup::setText(const char* text) {
@@ -3090,13 +4670,13 @@ void UIScrollTextPopup::setText(const char* text) {
     _text[TAB5_SCROLLTEXT_MAX_LEN - 1] = '\0';
     _needsWrap = true;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollTextPopup::setButtonLabel(const char* label) {
     strncpy(_btnLabel, label, sizeof(_btnLabel) - 1);
     _btnLabel[sizeof(_btnLabel) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollTextPopup::show() {
@@ -3106,24 +4686,24 @@ void UIScrollTextPopup::show() {
     _needsFrameRedraw = true;
     _needsWrap = true;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollTextPopup::hide() {
     _visible = false;
     _btnPressed = false;
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollTextPopup::scrollTo(int16_t offset) {
     _scrollOffset = offset;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIScrollTextPopup::scrollToBottom() {
     _scrollOffset = maxScroll();
-    _dirty = true;
+    setDirty();
 }
 
 int16_t UIScrollTextPopup::totalContentHeight() const {
@@ -3223,6 +4803,7 @@ int16_t UIScrollTextPopup::markdownTextWidth(LovyanGFX& gfx, const char* text,
 
 // ── Reflow: parse markdown blocks and word-wrap each paragraph ──
 void UIScrollTextPopup::reflow(LovyanGFX& gfx) {
+    TraceScope trace(TraceCat::REFLOW, "reflow", getTag(), strlen(_text));
     int16_t contentW = _bodyW - TAB5_LIST_SCROLLBAR_W - 4;
     _lineCount = 0;
 
@@ -3492,6 +5073,8 @@ void UIScrollTextPopup::draw(LovyanGFX& gfx) {
         _needsFrameRedraw = true;
     }
 
+    saveUnderCapture(gfx, this, _popX, _popY, _popW + 4, _popH + 4);
+
     // Reflow text if needed
     if (_needsWrap) {
         reflow(gfx);
@@ -3644,7 +5227,7 @@ void UIScrollTextPopup::draw(LovyanGFX& gfx) {
 
     // Push body sprite
     if (spr) {
-        spr->pushSprite(&gfx, _bodyX, _bodyY);
+        pushTraced(spr, gfx, _bodyX, _bodyY);
     }
 
     _dirty = false;
@@ -3660,7 +5243,7 @@ void UIScrollTextPopup::handleTouchDown(int16_t tx, int16_t ty) {
     if (hitTestBtn(tx, ty)) {
         _btnPressed = true;
         _needsFrameRedraw = true;
-        _dirty = true;
+        setDirty();
     } else if (hitTestBody(tx, ty)) {
         _dragging = true;
         _touchStartY = ty;
@@ -3682,7 +5265,7 @@ void UIScrollTextPopup::handleTouchMove(int16_t tx, int16_t ty) {
             int16_t dy = _touchStartY - ty;
             _scrollOffset = _scrollStart + dy;
             clampScroll();
-            _dirty = true;
+            setDirty();
         }
     }
 }
@@ -3694,19 +5277,19 @@ void UIScrollTextPopup::handleTouchUp(int16_t tx, int16_t ty) {
         // Close button tapped
         _btnPressed = false;
         hide();
-        if (_onDismiss) _onDismiss(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onDismiss", _onDismiss, TouchEvent::TOUCH_RELEASE);
     } else if (!hitTest(tx, ty) && !_wasDrag) {
         // Tap outside popup — dismiss
         _btnPressed = false;
         hide();
-        if (_onDismiss) _onDismiss(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onDismiss", _onDismiss, TouchEvent::TOUCH_RELEASE);
     } else {
         // Scroll drag ended or non-button touch — only redraw if
         // button visual state actually changed.
         if (_btnPressed) {
             _btnPressed = false;
             _needsFrameRedraw = true;
-            _dirty = true;
+            setDirty();
         }
     }
 
@@ -3730,7 +5313,7 @@ int UIList::addItem(const char* text) {
     _items[_itemCount] = UIListItem();  // reset to defaults
     strncpy(_items[_itemCount].text, text, sizeof(_items[0].text) - 1);
     _items[_itemCount].text[sizeof(_items[0].text) - 1] = '\0';
-    _dirty = true;
+    setDirty();
     return _itemCount++;
 }
 
@@ -3748,7 +5331,7 @@ int UIList::addItem(const char* text, const char* iconChar,
     _items[_itemCount].iconColor = iconColor;
     _items[_itemCount].iconBorderColor = iconBorderColor;
     _items[_itemCount].iconCharColor = iconCharColor;
-    _dirty = true;
+    setDirty();
     return _itemCount++;
 }
 
@@ -3763,14 +5346,14 @@ void UIList::setItemIcon(int index, const char* iconChar,
     _items[index].iconColor = iconColor;
     _items[index].iconBorderColor = iconBorderColor;
     _items[index].iconCharColor = iconCharColor;
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::clearItemIcon(int index) {
     if (index < 0 || index >= _itemCount) return;
     _items[index].hasIcon = false;
     _items[index].iconChar[0] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::removeItem(int index) {
@@ -3782,27 +5365,27 @@ void UIList::removeItem(int index) {
     if (_selectedIndex == index) _selectedIndex = -1;
     else if (_selectedIndex > index) _selectedIndex--;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::clearItems() {
     _itemCount = 0;
     _selectedIndex = -1;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::setItemText(int index, const char* text) {
     if (index < 0 || index >= _itemCount) return;
     strncpy(_items[index].text, text, sizeof(_items[0].text) - 1);
     _items[index].text[sizeof(_items[0].text) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::setItemEnabled(int index, bool enabled) {
     if (index < 0 || index >= _itemCount) return;
     _items[index].enabled = enabled;
-    _dirty = true;
+    setDirty();
 }
 
 const char* UIList::getSelectedText() const {
@@ -3813,18 +5396,18 @@ const char* UIList::getSelectedText() const {
 void UIList::setSelectedIndex(int index) {
     if (index < -1 || index >= _itemCount) return;
     _selectedIndex = index;
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::clearSelection() {
     _selectedIndex = -1;
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::scrollTo(int16_t offset) {
     _scrollOffset = offset;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIList::scrollToItem(int index) {
@@ -3841,7 +5424,7 @@ void UIList::scrollToItem(int index) {
         _scrollOffset = itemBottom - _h;
     }
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 int16_t UIList::maxScroll() const {
@@ -3997,7 +5580,7 @@ void UIList::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -4011,7 +5594,7 @@ void UIList::handleTouchDown(int16_t tx, int16_t ty) {
     _touchStartY = ty;
     _touchDownY = ty;
     _scrollStart = _scrollOffset;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIList::handleTouchMove(int16_t tx, int16_t ty) {
@@ -4028,7 +5611,7 @@ void UIList::handleTouchMove(int16_t tx, int16_t ty) {
     if (_wasDrag) {
         _scrollOffset = _scrollStart + dy;
         clampScroll();
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -4041,14 +5624,14 @@ void UIList::handleTouchUp(int16_t tx, int16_t ty) {
         int idx = itemAtY(ty);
         if (idx >= 0 && idx < _itemCount && _items[idx].enabled) {
             _selectedIndex = idx;
-            _dirty = true;
-            if (_onSelect) _onSelect(idx, _items[idx].text);
+            setDirty();
+            fireCallback(this, "onSelect", _onSelect, idx, _items[idx].text);
         }
     }
 
     _dragging = false;
     _wasDrag = false;
-    if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+    fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -4071,7 +5654,7 @@ UICheckbox::UICheckbox(int16_t x, int16_t y, int16_t w, int16_t h,
 void UICheckbox::setLabel(const char* label) {
     strncpy(_label, label, sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UICheckbox::draw(LovyanGFX& gfx) {
@@ -4115,16 +5698,16 @@ void UICheckbox::draw(LovyanGFX& gfx) {
 
 void UICheckbox::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
-    _pressed = true; _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    _pressed = true; setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UICheckbox::handleTouchUp(int16_t tx, int16_t ty) {
     if (_pressed) {
         _pressed = false;
         _checked = !_checked;  // Toggle on release
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -4149,12 +5732,12 @@ void UIRadioGroup::select(UIRadioButton* btn) {
     // Deselect previous
     if (_selected) {
         _selected->_selected = false;
-        _selected->_dirty = true;
+        _selected->setDirty();
     }
     _selected = btn;
     if (btn) {
         btn->_selected = true;
-        btn->_dirty = true;
+        btn->setDirty();
     }
 }
 
@@ -4187,7 +5770,7 @@ UIRadioButton::UIRadioButton(int16_t x, int16_t y, int16_t w, int16_t h,
 void UIRadioButton::setLabel(const char* label) {
     strncpy(_label, label, sizeof(_label) - 1);
     _label[sizeof(_label) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIRadioButton::setGroup(UIRadioGroup* g) {
@@ -4229,8 +5812,8 @@ void UIRadioButton::draw(LovyanGFX& gfx) {
 
 void UIRadioButton::handleTouchDown(int16_t tx, int16_t ty) {
     if (!hitTest(tx, ty)) return;
-    _pressed = true; _dirty = true;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    _pressed = true; setDirty();
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIRadioButton::handleTouchUp(int16_t tx, int16_t ty) {
@@ -4242,8 +5825,8 @@ void UIRadioButton::handleTouchUp(int16_t tx, int16_t ty) {
         } else {
             _selected = true;
         }
-        _dirty = true;
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        setDirty();
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -4269,7 +5852,7 @@ int UIDropdown::addItem(const char* text) {
     _items[_itemCount] = UIListItem();
     strncpy(_items[_itemCount].text, text, sizeof(_items[0].text) - 1);
     _items[_itemCount].text[sizeof(_items[0].text) - 1] = '\0';
-    _dirty = true;
+    setDirty();
     return _itemCount++;
 }
 
@@ -4287,7 +5870,7 @@ int UIDropdown::addItem(const char* text, const char* iconChar,
     _items[_itemCount].iconColor = iconColor;
     _items[_itemCount].iconBorderColor = iconBorderColor;
     _items[_itemCount].iconCharColor = iconCharColor;
-    _dirty = true;
+    setDirty();
     return _itemCount++;
 }
 
@@ -4302,14 +5885,14 @@ void UIDropdown::setItemIcon(int index, const char* iconChar,
     _items[index].iconColor = iconColor;
     _items[index].iconBorderColor = iconBorderColor;
     _items[index].iconCharColor = iconCharColor;
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::clearItemIcon(int index) {
     if (index < 0 || index >= _itemCount) return;
     _items[index].hasIcon = false;
     _items[index].iconChar[0] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::removeItem(int index) {
@@ -4321,27 +5904,27 @@ void UIDropdown::removeItem(int index) {
     if (_selectedIndex == index) _selectedIndex = -1;
     else if (_selectedIndex > index) _selectedIndex--;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::clearItems() {
     _itemCount = 0;
     _selectedIndex = -1;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::setItemText(int index, const char* text) {
     if (index < 0 || index >= _itemCount) return;
     strncpy(_items[index].text, text, sizeof(_items[0].text) - 1);
     _items[index].text[sizeof(_items[0].text) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::setItemEnabled(int index, bool enabled) {
     if (index < 0 || index >= _itemCount) return;
     _items[index].enabled = enabled;
-    _dirty = true;
+    setDirty();
 }
 
 const char* UIDropdown::getSelectedText() const {
@@ -4352,18 +5935,18 @@ const char* UIDropdown::getSelectedText() const {
 void UIDropdown::setSelectedIndex(int index) {
     if (index < -1 || index >= _itemCount) return;
     _selectedIndex = index;
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::clearSelection() {
     _selectedIndex = -1;
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::setPlaceholder(const char* text) {
     strncpy(_placeholder, text, sizeof(_placeholder) - 1);
     _placeholder[sizeof(_placeholder) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 // ── Open / Close ────────────────────────────────────────────────────────────
@@ -4380,13 +5963,13 @@ void UIDropdown::open() {
             clampScroll();
         }
     }
-    _dirty = true;
+    setDirty();
 }
 
 void UIDropdown::close() {
     // Save the list overlay footprint so draw() can erase it
     // (list geometry was calculated when the dropdown was opened/drawn)
-    if (_open) {
+    if (_open && !hasSaveUnder(this)) {
         _needsListErase = true;
         _eraseX = _listX;
         _eraseY = _listY;
@@ -4397,7 +5980,7 @@ void UIDropdown::close() {
     _btnPressed = false;
     _dragging = false;
     _wasDrag = false;
-    _dirty = true;
+    setDirty();
 }
 
 // ── Geometry helpers ────────────────────────────────────────────────────────
@@ -4526,6 +6109,10 @@ void UIDropdown::draw(LovyanGFX& gfx) {
     if (_open) {
         calcListGeometry();
 
+        // Snapshot the siblings beneath the list (+3 shadow) so closing
+        // is a single blit rather than an erase and sibling repaint
+        saveUnderCapture(gfx, this, _listX, _listY, _listW + 3, _listH + 3);
+
         // Sprite covers list + shadow (shadow offset +3,+3)
         int16_t sprW = _listW + 3;
         int16_t sprH = _listH + 3;
@@ -4651,7 +6238,7 @@ void UIDropdown::draw(LovyanGFX& gfx) {
 
         // Push sprite to display in one transfer (flicker-free)
         if (spr) {
-            spr->pushSprite(&gfx, _listX, _listY);
+            pushTraced(spr, gfx, _listX, _listY);
         }
     }
 
@@ -4681,8 +6268,8 @@ void UIDropdown::handleTouchDown(int16_t tx, int16_t ty) {
         // Collapsed: press the button
         if (hitTest(tx, ty)) {
             _btnPressed = true;
-            _dirty = true;
-            if (_onTouch) _onTouch(TouchEvent::TOUCH);
+            setDirty();
+            fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
         }
     }
 }
@@ -4701,7 +6288,7 @@ void UIDropdown::handleTouchMove(int16_t tx, int16_t ty) {
     if (_wasDrag) {
         _scrollOffset = _scrollStart + dy;
         clampScroll();
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -4718,7 +6305,7 @@ void UIDropdown::handleTouchUp(int16_t tx, int16_t ty) {
             int idx = itemAtY(ty);
             if (idx >= 0 && idx < _itemCount && _items[idx].enabled) {
                 _selectedIndex = idx;
-                if (_onSelect) _onSelect(idx, _items[idx].text);
+                fireCallback(this, "onSelect", _onSelect, idx, _items[idx].text);
             }
             close();
         } else if (inList && _pressed) {
@@ -4740,9 +6327,9 @@ void UIDropdown::handleTouchUp(int16_t tx, int16_t ty) {
             open();
         } else {
             _btnPressed = false;
-            _dirty = true;
+            setDirty();
         }
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
     }
 }
 
@@ -4766,7 +6353,7 @@ int UIColumnList::addColumn(const char* header, int16_t width, textdatum_t align
     col.header[sizeof(col.header) - 1] = '\0';
     col.width = width;
     col.align = align;
-    _dirty = true;
+    setDirty();
     return _colCount++;
 }
 
@@ -4774,19 +6361,19 @@ void UIColumnList::setColumnHeader(int col, const char* header) {
     if (col < 0 || col >= _colCount) return;
     strncpy(_columns[col].header, header, sizeof(_columns[0].header) - 1);
     _columns[col].header[sizeof(_columns[0].header) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::setColumnWidth(int col, int16_t width) {
     if (col < 0 || col >= _colCount) return;
     _columns[col].width = width;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::setColumnAlign(int col, textdatum_t align) {
     if (col < 0 || col >= _colCount) return;
     _columns[col].align = align;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::setColumnSortable(int col, bool sortable) {
@@ -4800,7 +6387,7 @@ int UIColumnList::addRow() {
     if (_rowCount >= TAB5_LIST_MAX_ITEMS) return -1;
     _rows[_rowCount] = UIColumnListRow();  // reset to defaults
     _sortOrderDirty = true;
-    _dirty = true;
+    setDirty();
     return _rowCount++;
 }
 
@@ -4814,7 +6401,7 @@ void UIColumnList::removeRow(int index) {
     else if (_selectedIndex > index) _selectedIndex--;
     _sortOrderDirty = true;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::clearRows() {
@@ -4822,13 +6409,13 @@ void UIColumnList::clearRows() {
     _selectedIndex = -1;
     _scrollOffset = 0;
     _sortOrderDirty = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::setRowEnabled(int row, bool enabled) {
     if (row < 0 || row >= _rowCount) return;
     _rows[row].enabled = enabled;
-    _dirty = true;
+    setDirty();
 }
 
 // ── Cell content ────────────────────────────────────────────────────────────
@@ -4841,7 +6428,7 @@ void UIColumnList::setCellText(int row, int col, const char* text) {
     cell.iconData = nullptr;
     cell.iconSize = 0;
     cell.useCustomColor = false;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::setCellText(int row, int col, const char* text, uint32_t textColor) {
@@ -4853,7 +6440,7 @@ void UIColumnList::setCellText(int row, int col, const char* text, uint32_t text
     cell.iconSize = 0;
     cell.textColor = textColor;
     cell.useCustomColor = true;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::setCellIcon(int row, int col,
@@ -4863,13 +6450,13 @@ void UIColumnList::setCellIcon(int row, int col,
     cell.iconData = iconData;
     cell.iconSize = iconSize;
     cell.text[0] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::clearCell(int row, int col) {
     if (row < 0 || row >= _rowCount || col < 0 || col >= _colCount) return;
     _rows[row].cells[col] = UIColumnCell();
-    _dirty = true;
+    setDirty();
 }
 
 const char* UIColumnList::getCellText(int row, int col) const {
@@ -4887,12 +6474,12 @@ const char* UIColumnList::getSelectedText() const {
 void UIColumnList::setSelectedIndex(int index) {
     if (index < -1 || index >= _rowCount) return;
     _selectedIndex = index;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::clearSelection() {
     _selectedIndex = -1;
-    _dirty = true;
+    setDirty();
 }
 
 // ── Scroll ──────────────────────────────────────────────────────────────────
@@ -4900,7 +6487,7 @@ void UIColumnList::clearSelection() {
 void UIColumnList::scrollTo(int16_t offset) {
     _scrollOffset = offset;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::scrollToRow(int index) {
@@ -4914,7 +6501,7 @@ void UIColumnList::scrollToRow(int index) {
         _scrollOffset = itemTop + _itemH - visibleH;
     }
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 int16_t UIColumnList::maxScroll() const {
@@ -4986,7 +6573,7 @@ void UIColumnList::sortByColumn(int col, SortDir dir) {
     _sortOrderDirty = true;
     _scrollOffset = 0;
     _selectedIndex = -1;   // Selection indices would be stale
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::clearSort() {
@@ -4995,10 +6582,11 @@ void UIColumnList::clearSort() {
     _sortOrderDirty = true;
     _scrollOffset = 0;
     _selectedIndex = -1;
-    _dirty = true;
+    setDirty();
 }
 
 void UIColumnList::rebuildSortOrder() {
+    TraceScope trace(TraceCat::SORT, "sort", getTag(), _rowCount);
     // Initialize identity mapping
     for (int i = 0; i < _rowCount; i++) {
         _sortOrder[i] = i;
@@ -5172,8 +6760,10 @@ void UIColumnList::draw(LovyanGFX& gfx) {
                 int16_t icoH = iconSize;
                 int16_t icoX = cx + (colW - icoW) / 2;
                 int16_t icoY = rowY + (_itemH - icoH) / 2;
-                dst.drawPng(cell.iconData, cell.iconSize,
-                            icoX, icoY, icoW, icoH);
+                uint32_t rowBg = (i == _selectedIndex) ? rgb888(_selectColor)
+                                                       : rgb888(_bgColor);
+                drawIcon(dst, cell.iconData, cell.iconSize,
+                         icoX, icoY, icoW, icoH, rowBg);
             } else if (cell.text[0] != '\0') {
                 // ── Draw text ──
                 dst.setTextSize(_textSize);
@@ -5242,7 +6832,7 @@ void UIColumnList::draw(LovyanGFX& gfx) {
 
     // Push sprite
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -5271,7 +6861,7 @@ void UIColumnList::handleTouchDown(int16_t tx, int16_t ty) {
     _touchDownX = tx;
     _touchDownY = ty;
     _scrollStart = _scrollOffset;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UIColumnList::handleTouchMove(int16_t tx, int16_t ty) {
@@ -5287,7 +6877,7 @@ void UIColumnList::handleTouchMove(int16_t tx, int16_t ty) {
     if (_wasDrag) {
         _scrollOffset = _scrollStart + dy;
         clampScroll();
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -5311,7 +6901,7 @@ void UIColumnList::handleTouchUp(int16_t tx, int16_t ty) {
                 sortByColumn(col, SortDir::ASC);
             }
         }
-        if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+        fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
         return;
     }
 
@@ -5321,15 +6911,15 @@ void UIColumnList::handleTouchUp(int16_t tx, int16_t ty) {
             int dataIdx = _sortOrder[idx];
             if (_rows[dataIdx].enabled) {
                 _selectedIndex = idx;
-                _dirty = true;
-                if (_onSelect) _onSelect(idx, _rows[dataIdx].cells[0].text);
+                setDirty();
+                fireCallback(this, "onSelect", _onSelect, idx, _rows[dataIdx].cells[0].text);
             }
         }
     }
 
     _dragging = false;
     _wasDrag = false;
-    if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+    fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -5356,7 +6946,7 @@ void UITextArea::setText(const char* text) {
     _cursorPos = (int)strlen(_text);
     _needsWrap = true;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UITextArea::clear() {
@@ -5364,21 +6954,21 @@ void UITextArea::clear() {
     _cursorPos = 0;
     _needsWrap = true;
     _scrollOffset = 0;
-    _dirty = true;
+    setDirty();
 }
 
 void UITextArea::setPlaceholder(const char* ph) {
     strncpy(_placeholder, ph, sizeof(_placeholder) - 1);
     _placeholder[sizeof(_placeholder) - 1] = '\0';
-    _dirty = true;
+    setDirty();
 }
 
 void UITextArea::focus() {
     if (_focused) return;
     _focused = true;
-    _dirty = true;
+    setDirty();
     if (_keyboard) {
-        _keyboard->setOnKey([this](char ch) { this->onKeyPress(ch); });
+        _keyboard->_inputHook = [this](char ch) { this->onKeyPress(ch); };
         _keyboard->show();
     }
 }
@@ -5386,7 +6976,7 @@ void UITextArea::focus() {
 void UITextArea::blur() {
     if (!_focused) return;
     _focused = false;
-    _dirty = true;
+    setDirty();
     if (_keyboard && _keyboard->isOpen()) {
         _keyboard->hide();
     }
@@ -5400,7 +6990,7 @@ void UITextArea::onKeyPress(char ch) {
     }
     if (ch == '\n') {
         // Done key — submit and close keyboard
-        if (_onSubmit) _onSubmit(_text);
+        fireCallback(this, "onSubmit", _onSubmit, _text);
         blur();
         return;
     }
@@ -5414,8 +7004,8 @@ void UITextArea::onKeyPress(char ch) {
             _text[_cursorPos] = '\n';
             _cursorPos++;
             _needsWrap = true;
-            _dirty = true;
-            if (_onChange) _onChange(_text);
+            setDirty();
+            fireCallback(this, "onChange", _onChange, _text);
         }
         return;
     }
@@ -5429,8 +7019,8 @@ void UITextArea::onKeyPress(char ch) {
             }
             _cursorPos--;
             _needsWrap = true;
-            _dirty = true;
-            if (_onChange) _onChange(_text);
+            setDirty();
+            fireCallback(this, "onChange", _onChange, _text);
         }
         return;
     }
@@ -5444,20 +7034,20 @@ void UITextArea::onKeyPress(char ch) {
         _text[_cursorPos] = ch;
         _cursorPos++;
         _needsWrap = true;
-        _dirty = true;
-        if (_onChange) _onChange(_text);
+        setDirty();
+        fireCallback(this, "onChange", _onChange, _text);
     }
 }
 
 void UITextArea::scrollTo(int16_t offset) {
     _scrollOffset = offset;
     clampScroll();
-    _dirty = true;
+    setDirty();
 }
 
 void UITextArea::scrollToBottom() {
     _scrollOffset = maxScroll();
-    _dirty = true;
+    setDirty();
 }
 
 int16_t UITextArea::totalContentHeight() const {
@@ -5483,6 +7073,7 @@ void UITextArea::clampScroll() {
 
 // ── Word-wrap the text buffer into display lines ──
 void UITextArea::reflow(LovyanGFX& gfx) {
+    TraceScope trace(TraceCat::REFLOW, "reflow", getTag(), strlen(_text));
     int16_t contentW = _w - TAB5_PADDING * 2 - TAB5_LIST_SCROLLBAR_W - 4;
     _lineCount = 0;
 
@@ -5807,7 +7398,7 @@ void UITextArea::draw(LovyanGFX& gfx) {
 
     // Push sprite to display in one transfer (flicker-free)
     if (spr) {
-        spr->pushSprite(&gfx, _x, _y);
+        pushTraced(spr, gfx, _x, _y);
     }
 
     _dirty = false;
@@ -5822,7 +7413,7 @@ void UITextArea::handleTouchDown(int16_t tx, int16_t ty) {
     _touchDownX = tx;
     _touchDownY = ty;
     _scrollStart = _scrollOffset;
-    if (_onTouch) _onTouch(TouchEvent::TOUCH);
+    fireCallback(this, "onTouch", _onTouch, TouchEvent::TOUCH);
 }
 
 void UITextArea::handleTouchMove(int16_t tx, int16_t ty) {
@@ -5839,7 +7430,7 @@ void UITextArea::handleTouchMove(int16_t tx, int16_t ty) {
     if (_wasDrag) {
         _scrollOffset = _scrollStart + dy;
         clampScroll();
-        _dirty = true;
+        setDirty();
     }
 }
 
@@ -5857,13 +7448,1100 @@ void UITextArea::handleTouchUp(int16_t tx, int16_t ty) {
             _pendingTap = true;
             _pendingTapX = tx;
             _pendingTapY = ty;
-            _dirty = true;
+            setDirty();
+        }
+    }
+
+    _dragging = false;
+    _wasDrag = false;
+    fireCallback(this, "onRelease", _onRelease, TouchEvent::TOUCH_RELEASE);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  UIChart
+// ═════════════════════════════════════════════════════════════════════════════
+// Column c of the plot (0 = left) shows, for each series, the sample
+// (plotW - 1 - c) + pending steps back from its newest: pending samples are
+// buffered but not yet scrolled on screen.
+
+static constexpr int16_t  CHART_SCALE_W   = 64;    // Scale label column
+static constexpr uint32_t CHART_SLACK     = 256;   // Samples kept beyond the plot width
+static constexpr uint32_t CHART_MIN_TOP   = 64;    // Fewest buckets in the top pyramid level
+
+// Samples per bucket at pyramid level l: 8^(l+1)
+static inline uint32_t chartSpanShift(int l) { return 3 * (l + 1); }
+
+static inline void chartMerge(float& lo, float& hi, float blo, float bhi) {
+    if (blo < lo) lo = blo;
+    if (bhi > hi) hi = bhi;
+}
+
+UIChart::UIChart(int16_t x, int16_t y, int16_t w, int16_t h,
+                 uint32_t bgColor, uint32_t gridColor)
+    : UIElement(x, y, w, h)
+    , _bgColor(bgColor)
+    , _gridColor(gridColor)
+{
+    layout();
+}
+
+UIChart::~UIChart() {
+    for (int i = 0; i < _seriesCount; i++) {
+        free(_series[i].data);
+        free(_series[i].levels[0]);
+    }
+}
+
+void UIChart::memoryInfo(UIMemoryInfo& m) const {
+    m.type = "UIChart";
+    m.objectBytes = sizeof(*this);
+    for (int i = 0; i < _seriesCount; i++) {
+        const UIChartSeries& s = _series[i];
+        m.psramBytes += s.capacity * sizeof(float);
+        for (int l = 0; l < s.levelCount; l++) {
+            m.psramBytes += (s.capacity >> chartSpanShift(l)) * sizeof(UIChartBucket);
+        }
+    }
+}
+
+void UIChart::layout() {
+    _plotX = (_showScale ? CHART_SCALE_W : 0) + 1;
+    _plotY = 1;
+    _plotW = std::max<int16_t>(1, _w - _plotX - 1);
+    _plotH = std::max<int16_t>(1, _h - 2);
+}
+
+int UIChart::addSeries(uint32_t color, uint32_t capacity) {
+    if (_seriesCount >= TAB5_CHART_MAX_SERIES) return -1;
+    layout();
+    capacity = std::max<uint32_t>(capacity, (uint32_t)_plotW + CHART_SLACK);
+
+    // Add levels while the top one keeps at least CHART_MIN_TOP buckets,
+    // then round the capacity up to whole top buckets (< 1/64 extra) so
+    // every level wraps with the ring
+    int levels = 0;
+    while (levels < TAB5_CHART_MAX_LEVELS &&
+           ((uint64_t)CHART_MIN_TOP << chartSpanShift(levels)) <= capacity) {
+        levels++;
+    }
+    uint32_t top = levels ? (1u << chartSpanShift(levels - 1)) : 1;
+    capacity = (capacity + top - 1) / top * top;
+
+    uint32_t buckets = 0;
+    for (int l = 0; l < levels; l++) buckets += capacity >> chartSpanShift(l);
+
+    float* data = (float*)allocPixels(capacity * sizeof(float));
+    UIChartBucket* pyramid = buckets ? (UIChartBucket*)allocPixels(buckets * sizeof(UIChartBucket)) : nullptr;
+    if (!data || (buckets && !pyramid)) {
+        free(data);
+        free(pyramid);
+        return -1;
+    }
+
+    UIChartSeries& s = _series[_seriesCount];
+    s = UIChartSeries();
+    s.data       = data;
+    s.capacity   = capacity;
+    s.color      = color;
+    s.levelCount = levels;
+    for (int l = 0; l < levels; l++) {
+        s.levels[l] = pyramid;
+        pyramid += capacity >> chartSpanShift(l);
+    }
+    invalidate();
+    return _seriesCount++;
+}
+
+void UIChart::setSeriesColor(int series, uint32_t color) {
+    if (series < 0 || series >= _seriesCount) return;
+    _series[series].color = color;
+    invalidate();
+}
+
+// Store one sample and fold it into the bucket holding it at every
+// pyramid level; the first sample of a bucket resets it, which is what
+// recycles the oldest bucket once the ring wraps
+void UIChart::append(UIChartSeries& s, float v) {
+    uint64_t i = s.total++;
+    s.data[s.head] = v;
+    s.head = (s.head + 1) % s.capacity;
+    if (s.count   < s.capacity) s.count++;
+    if (s.pending < s.capacity) s.pending++;
+
+    for (int l = 0; l < s.levelCount; l++) {
+        uint32_t shift = chartSpanShift(l);
+        uint64_t span  = 1ull << shift;
+        UIChartBucket& b = s.levels[l][(i >> shift) % (s.capacity >> shift)];
+        if ((i & (span - 1)) == 0) b = { INFINITY, -INFINITY };
+        if (!isnan(v)) chartMerge(b.lo, b.hi, v, v);
+    }
+}
+
+void UIChart::push(float value, int series) {
+    if (series < 0 || series >= _seriesCount) return;
+    append(_series[series], value);
+    if (isLive() || _viewFollow) setDirty();
+}
+
+void UIChart::pushBlock(const float* values, uint32_t n, int series) {
+    if (series < 0 || series >= _seriesCount || !values) return;
+    UIChartSeries& s = _series[series];
+    for (uint32_t i = 0; i < n; i++) append(s, values[i]);
+    if (n && (isLive() || _viewFollow)) setDirty();
+}
+
+float UIChart::sample(int series, uint32_t age) const {
+    if (series < 0 || series >= _seriesCount) return NAN;
+    const UIChartSeries& s = _series[series];
+    if (age >= s.count) return NAN;
+    return s.data[(s.head + s.capacity - 1 - age) % s.capacity];
+}
+
+uint32_t UIChart::sampleCount(int series) const {
+    if (series < 0 || series >= _seriesCount) return 0;
+    return _series[series].count;
+}
+
+void UIChart::clear() {
+    for (int i = 0; i < _seriesCount; i++) {
+        _series[i].head = _series[i].count = _series[i].pending = 0;
+        _series[i].total = 0;
+    }
+    _viewEnd  = 0;
+    _columns  = 0;
+    _haveData = false;
+    _extentsStale = false;
+    invalidate();
+}
+
+void UIChart::setRange(float lo, float hi) {
+    if (!(hi > lo)) return;
+    _autoScale = false;
+    _lo = lo;
+    _hi = hi;
+    invalidate();
+}
+
+void UIChart::setAutoScale(bool on) {
+    _autoScale = on;
+    invalidate();
+}
+
+void UIChart::setGrid(uint8_t rows, uint16_t columnEvery) {
+    _gridRows  = rows;
+    _gridEvery = columnEvery;
+    invalidate();
+}
+
+void UIChart::setShowScale(bool show) {
+    _showScale = show;
+    layout();
+    invalidate();
+}
+
+void UIChart::setView(uint32_t span, uint32_t offset) {
+    if (span == 0 || _seriesCount == 0) return setLive();
+    const UIChartSeries& s = _series[0];
+    _viewSpan   = span;
+    _viewFollow = offset == 0;
+    _viewEnd    = s.total - std::min<uint64_t>(offset, s.total);
+    invalidate();
+}
+
+void UIChart::setLive() {
+    if (isLive()) return;
+    _viewSpan = 0;
+    _extentsStale = true;      // The view's range says nothing about the live plot
+    invalidate();
+}
+
+uint32_t UIChart::getViewSpan() const {
+    return isLive() ? (uint32_t)_plotW : _viewSpan;
+}
+
+uint32_t UIChart::getViewOffset() const {
+    if (isLive() || _viewFollow || _seriesCount == 0) return 0;
+    return (uint32_t)std::min<uint64_t>(_series[0].total - _viewEnd, UINT32_MAX);
+}
+
+void UIChart::setDrawMode(ChartMode m) {
+    _mode = m;
+    invalidate();
+}
+
+// Columns every series can scroll in
+uint32_t UIChart::readyColumns() const {
+    if (_seriesCount == 0) return 0;
+    uint32_t k = _series[0].pending;
+    for (int i = 1; i < _seriesCount; i++) k = std::min(k, _series[i].pending);
+    return k;
+}
+
+// Scroll k pending samples onto the plot, tracking the on-screen extremes:
+// new samples can only widen them; when an extreme scrolls off they are
+// rescanned
+bool UIChart::advance(uint32_t k) {
+    uint32_t w = (uint32_t)_plotW;
+    for (int i = 0; i < _seriesCount; i++) {
+        UIChartSeries& s = _series[i];
+        s.pending -= k;
+        if (k >= w) {               // Whole plot replaced
+            _extentsStale = true;
+            continue;
+        }
+        for (uint32_t a = s.pending; a < s.pending + k; a++) {
+            float v = sample(i, a);
+            if (isnan(v)) continue;
+            if (!_haveData) {
+                _dataMin = _dataMax = v;
+                _haveData = true;
+            }
+            _dataMin = std::min(_dataMin, v);
+            _dataMax = std::max(_dataMax, v);
+        }
+        for (uint32_t a = s.pending + w; a < s.pending + w + k; a++) {
+            if (a >= s.count) {
+                // Overwritten before it scrolled off: unknown, so rescan
+                if (a < s.capacity) break;
+                _extentsStale = true;
+                break;
+            }
+            float v = sample(i, a);
+            if (v <= _dataMin || v >= _dataMax) _extentsStale = true;
+        }
+    }
+    _columns += k;
+    return k > 0;
+}
+
+void UIChart::rescanExtents() {
+    _extentsStale = false;
+    _haveData = false;
+    for (int i = 0; i < _seriesCount; i++) {
+        const UIChartSeries& s = _series[i];
+        for (uint32_t a = s.pending; a < s.pending + (uint32_t)_plotW && a < s.count; a++) {
+            float v = sample(i, a);
+            if (isnan(v)) continue;
+            if (!_haveData) {
+                _dataMin = _dataMax = v;
+                _haveData = true;
+            }
+            _dataMin = std::min(_dataMin, v);
+            _dataMax = std::max(_dataMax, v);
+        }
+    }
+}
+
+// Autoscale with hysteresis: rescale when data leaves the range or spans
+// less than 40% of it, to the data extremes plus 15% headroom each side
+bool UIChart::updateRange() {
+    if (!_autoScale || !_haveData) return false;
+    float span = _dataMax - _dataMin;
+    if (span <= 0.0f) span = fabsf(_dataMax) * 0.1f + 1.0f;
+    bool outside  = _dataMin < _lo || _dataMax > _hi;
+    bool tooLoose = span < (_hi - _lo) * 0.4f;
+    if (!outside && !tooLoose) return false;
+    float pad = span * 0.15f;
+    _lo = _dataMin - pad;
+    _hi = _dataMax + pad;
+    return true;
+}
+
+int16_t UIChart::valueToY(float v) const {
+    float t = (v - _lo) / (_hi - _lo);
+    t = std::min(1.0f, std::max(0.0f, t));
+    return _plotY + _plotH - 1 - (int16_t)lroundf(t * (_plotH - 1));
+}
+
+void UIChart::drawFrame(LovyanGFX& dst, int16_t ox, int16_t oy) {
+    dst.fillRect(ox, oy, _w, _h, rgb888(_bgColor));
+    dst.drawRect(ox + _plotX - 1, oy, _plotW + 2, _h, rgb888(Tab5Theme::BORDER));
+
+    if (!_showScale) return;
+    char buf[16];
+    dst.setTextSize(TAB5_FONT_SIZE_SM);
+    dst.setTextColor(rgb888(Tab5Theme::TEXT_SECONDARY));
+    int16_t lx = ox + _plotX - 6;
+    snprintf(buf, sizeof(buf), "%.4g", _hi);
+    dst.setTextDatum(textdatum_t::top_right);
+    dst.drawString(buf, lx, oy + _plotY + 2);
+    snprintf(buf, sizeof(buf), "%.4g", (_lo + _hi) * 0.5f);
+    dst.setTextDatum(textdatum_t::middle_right);
+    dst.drawString(buf, lx, oy + _plotY + _plotH / 2);
+    snprintf(buf, sizeof(buf), "%.4g", _lo);
+    dst.setTextDatum(textdatum_t::bottom_right);
+    dst.drawString(buf, lx, oy + _plotY + _plotH - 2);
+}
+
+// Background, grid and one vertical span per series for plot columns
+// [c0, c1): from the previous sample's Y to this one's, so consecutive
+// columns join into a continuous trace
+void UIChart::drawColumns(LovyanGFX& dst, int16_t ox, int16_t oy, int16_t c0, int16_t c1) {
+    int16_t x0 = ox + _plotX;
+    int16_t y0 = oy + _plotY;
+    dst.fillRect(x0 + c0, y0, c1 - c0, _plotH, rgb888(_bgColor));
+
+    uint32_t grid = rgb888(_gridColor);
+    for (int r = 1; r < _gridRows; r++) {
+        dst.drawFastHLine(x0 + c0, y0 + r * _plotH / _gridRows, c1 - c0, grid);
+    }
+    if (_gridEvery) {
+        // Lines sit on absolute sample numbers, so they scroll with the data
+        for (int16_t c = c0; c < c1; c++) {
+            if (_columns + c < (uint32_t)_plotW) continue;
+            if ((_columns + c - _plotW) % _gridEvery == 0) dst.drawFastVLine(x0 + c, y0, _plotH, grid);
+        }
+    }
+
+    for (int i = 0; i < _seriesCount; i++) {
+        const UIChartSeries& s = _series[i];
+        uint32_t color = rgb888(s.color);
+        for (int16_t c = c0; c < c1; c++) {
+            uint32_t a = (uint32_t)(_plotW - 1 - c) + s.pending;
+            float v = sample(i, a);
+            if (isnan(v)) continue;
+            int16_t y  = valueToY(v);
+            float   pv = sample(i, a + 1);
+            int16_t yp = isnan(pv) ? y : valueToY(pv);
+            dst.drawFastVLine(x0 + c, oy + std::min(y, yp), std::abs(y - yp) + 1, color);
+        }
+    }
+}
+
+// ── Zoomed / panned view ──
+
+float UIChart::sampleAt(const UIChartSeries& s, int64_t i) const {
+    if (i < (int64_t)(s.total - s.count) || i >= (int64_t)s.total) return NAN;
+    return s.data[(uint64_t)i % s.capacity];
+}
+
+// Absolute sample number just past the view, for series s.  The view is
+// anchored to series 0 and applies the same offset to the others.
+int64_t UIChart::viewEnd(const UIChartSeries& s) const {
+    uint64_t back = _viewFollow ? 0 : _series[0].total - _viewEnd;
+    return (int64_t)s.total - (int64_t)back;
+}
+
+// Min and max of samples [a, b), from the largest aligned pyramid buckets
+// that fit plus raw samples at the ragged ends: at most 7 reads per level
+// each side, however long the span.  false if it holds no (non-NaN) data.
+bool UIChart::spanMinMax(const UIChartSeries& s, int64_t a, int64_t b,
+                         float& lo, float& hi) const {
+    lo = INFINITY;
+    hi = -INFINITY;
+    a = std::max<int64_t>(a, (int64_t)(s.total - s.count));
+    b = std::min<int64_t>(b, (int64_t)s.total);
+    while (a < b) {
+        int l = s.levelCount - 1;
+        for (; l >= 0; l--) {
+            int64_t span = 1ll << chartSpanShift(l);
+            if ((a & (span - 1)) == 0 && a + span <= b) break;
+        }
+        if (l < 0) {
+            float v = s.data[(uint64_t)a % s.capacity];
+            if (!isnan(v)) chartMerge(lo, hi, v, v);
+            a++;
+        } else {
+            uint32_t shift = chartSpanShift(l);
+            const UIChartBucket& bk = s.levels[l][((uint64_t)a >> shift) % (s.capacity >> shift)];
+            chartMerge(lo, hi, bk.lo, bk.hi);
+            a += 1ll << shift;
+        }
+    }
+    return lo <= hi;
+}
+
+// Largest-Triangle-Three-Buckets: per column, the sample forming the
+// largest triangle with the previous pick and the next column's mean, so
+// peaks survive while the trace stays one line.  Reads every sample in view.
+void UIChart::drawLTTB(LovyanGFX& dst, const UIChartSeries& s, int16_t x0,
+                       int16_t oy, int64_t start, uint32_t color) {
+    uint64_t span  = _viewSpan;
+    int16_t  w     = _plotW;
+    int64_t  first = (int64_t)(s.total - s.count);
+    int64_t  last  = (int64_t)s.total;
+    auto colStart = [&](int c) {
+        return std::min(last, std::max(first, start + (int64_t)((uint64_t)c * span / w)));
+    };
+
+    bool    havePrev = false;
+    float   ax = 0.0f, ay = 0.0f;          // Previous pick, x relative to start
+    int16_t px = 0, py = 0;
+    for (int16_t c = 0; c < w; c++) {
+        int64_t a = colStart(c), b = colStart(c + 1);
+
+        float nx = 0.0f, ny = 0.0f;
+        int   n  = 0;
+        for (int64_t i = b, e = colStart(c + 2); i < e; i++) {
+            float v = s.data[(uint64_t)i % s.capacity];
+            if (isnan(v)) continue;
+            nx += (float)(i - start);
+            ny += v;
+            n++;
+        }
+        if (n) {
+            nx /= n;
+            ny /= n;
+        }
+
+        int64_t best = -1;
+        float   bestV = 0.0f, bestArea = -1.0f;
+        for (int64_t i = a; i < b; i++) {
+            float v = s.data[(uint64_t)i % s.capacity];
+            if (isnan(v)) continue;
+            if (!havePrev) {                   // Start of a run: its first sample
+                best  = i;
+                bestV = v;
+                break;
+            }
+            float bx = (float)(i - start);
+            float area = n ? fabsf((ax - nx) * (v - ay) - (ax - bx) * (ny - ay))
+                           : fabsf(v - ay);
+            if (area > bestArea) {
+                bestArea = area;
+                best  = i;
+                bestV = v;
+            }
+        }
+        if (best < 0) {
+            havePrev = false;                  // Gap
+            continue;
+        }
+
+        int16_t x = x0 + c;
+        int16_t y = oy + valueToY(bestV);
+        if (havePrev) dst.drawLine(px, py, x, y, color);
+        else          dst.drawPixel(x, y, color);
+        ax = (float)(best - start);
+        ay = bestV;
+        px = x;
+        py = y;
+        havePrev = true;
+    }
+}
+
+void UIChart::drawView(LovyanGFX& dst, int16_t ox, int16_t oy) {
+    uint64_t span = _viewSpan;
+    int16_t  w    = _plotW;
+
+    if (_autoScale) {
+        _haveData = false;
+        for (int i = 0; i < _seriesCount; i++) {
+            float lo, hi;
+            int64_t end = viewEnd(_series[i]);
+            if (!spanMinMax(_series[i], end - (int64_t)span, end, lo, hi)) continue;
+            _dataMin = _haveData ? std::min(_dataMin, lo) : lo;
+            _dataMax = _haveData ? std::max(_dataMax, hi) : hi;
+            _haveData = true;
+        }
+        updateRange();
+    }
+    drawFrame(dst, ox, oy);
+
+    int16_t x0 = ox + _plotX;
+    int16_t y0 = oy + _plotY;
+    uint32_t grid = rgb888(_gridColor);
+    for (int r = 1; r < _gridRows; r++) {
+        dst.drawFastHLine(x0, y0 + r * _plotH / _gridRows, w, grid);
+    }
+
+    int64_t start0 = viewEnd(_series[0]) - (int64_t)span;
+    auto colStart = [&](int64_t start, int c) {
+        return start + (int64_t)((uint64_t)c * span / w);
+    };
+    if (_gridEvery) {
+        // Keep lines about _gridEvery pixels apart, on absolute sample numbers
+        int64_t step = (int64_t)_gridEvery * (int64_t)((span + w - 1) / w);
+        for (int16_t c = 0; c < w; c++) {
+            int64_t a = colStart(start0, c), b = colStart(start0, c + 1);
+            if (a < 0 || b <= a) continue;
+            if ((a + step - 1) / step * step < b) dst.drawFastVLine(x0 + c, y0, _plotH, grid);
+        }
+    }
+
+    for (int i = 0; i < _seriesCount; i++) {
+        const UIChartSeries& s = _series[i];
+        uint32_t color = rgb888(s.color);
+        int64_t  start = viewEnd(s) - (int64_t)span;
+
+        if (span <= (uint64_t)w) {
+            // Zoomed in: a line through every sample
+            bool havePrev = false;
+            int16_t px = 0, py = 0;
+            for (int64_t k = 0; k < (int64_t)span; k++) {
+                float v = sampleAt(s, start + k);
+                if (isnan(v)) {
+                    havePrev = false;
+                    continue;
+                }
+                int16_t x = x0 + (int16_t)((2 * k + 1) * w / (2 * (int64_t)span));
+                int16_t y = oy + valueToY(v);
+                if (havePrev) dst.drawLine(px, py, x, y, color);
+                else          dst.drawPixel(x, y, color);
+                px = x;
+                py = y;
+                havePrev = true;
+            }
+        } else if (_mode == ChartMode::LINE) {
+            drawLTTB(dst, s, x0, oy, start, color);
+        } else {
+            // One min–max span per column, stretched to meet the previous
+            // column so the envelope stays connected
+            bool  havePrev = false;
+            float prevLo = 0.0f, prevHi = 0.0f;
+            for (int16_t c = 0; c < w; c++) {
+                float lo, hi;
+                if (!spanMinMax(s, colStart(start, c), colStart(start, c + 1), lo, hi)) {
+                    havePrev = false;
+                    continue;
+                }
+                float top = havePrev ? std::max(hi, prevLo) : hi;
+                float bot = havePrev ? std::min(lo, prevHi) : lo;
+                int16_t yt = valueToY(top), yb = valueToY(bot);
+                dst.drawFastVLine(x0 + c, oy + yt, yb - yt + 1, color);
+                prevLo = lo;
+                prevHi = hi;
+                havePrev = true;
+            }
+        }
+    }
+}
+
+void UIChart::draw(LovyanGFX& gfx) {
+    if (!_visible) return;
+    layout();
+
+    // Scroll in place only while the panel still shows our last frame
+    uint32_t k = readyColumns();
+    bool full = _damaged || &gfx != _lastTarget || k >= (uint32_t)_plotW || !isLive();
+    if (k) advance(k);
+    if (_extentsStale) rescanExtents();
+    if (isLive() && updateRange()) full = true;
+    if (!full) {
+        int32_t cx, cy, cw, ch;
+        gfx.getClipRect(&cx, &cy, &cw, &ch);
+        int32_t px = _x + _plotX, py = _y + _plotY;
+        full = cx > px || cy > py || cx + cw < px + _plotW || cy + ch < py + _plotH;
+    }
+    _damaged    = false;
+    _lastTarget = &gfx;
+
+    if (full) {
+        M5Canvas* spr = acquireSprite(&gfx, _w, _h);
+        LovyanGFX& dst = spr ? (LovyanGFX&)*spr : gfx;
+        int16_t ox = spr ? 0 : _x;
+        int16_t oy = spr ? 0 : _y;
+        if (isLive()) {
+            drawFrame(dst, ox, oy);
+            drawColumns(dst, ox, oy, 0, _plotW);
+        } else {
+            drawView(dst, ox, oy);
+        }
+        if (spr) pushTraced(spr, gfx, _x, _y);
+        return;
+    }
+    if (k == 0) return;
+
+    // Move the existing trace left by k columns, then draw the new ones
+    int16_t px = _x + _plotX, py = _y + _plotY;
+    int16_t c0 = _plotW - (int16_t)k;
+    gfx.copyRect(px, py, c0, _plotH, px + (int16_t)k, py);
+    M5Canvas* spr = acquireSprite(&gfx, (int16_t)k, _plotH);
+    if (spr) {
+        drawColumns(*spr, -(_plotX + c0), -_plotY, c0, _plotW);
+        pushTraced(spr, gfx, px + c0, py);
+    } else {
+        drawColumns(gfx, _x, _y, c0, _plotW);
+    }
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  UIWaterfall
+// ═════════════════════════════════════════════════════════════════════════════
+// Line r of the display (0 = newest) is ring slot (_newest + r) % _lines.
+// New lines are written one slot *down*, so for DOWN the rows from any slot
+// to the end of the buffer are already in top-to-bottom screen order and
+// push as one image.
+
+// Black → blue → cyan → yellow → red → white
+static const uint32_t WATERFALL_DEFAULT_MAP[] = {
+    0x000000, 0x000080, 0x0060FF, 0x00E0E0, 0xFFFF00, 0xFF2000, 0xFFFFFF
+};
+
+UIWaterfall::UIWaterfall(int16_t x, int16_t y, int16_t w, int16_t h, WaterfallFlow flow)
+    : UIElement(x, y, w, h)
+    , _flow(flow)
+{
+    setColorMap(nullptr, 0);
+}
+
+UIWaterfall::~UIWaterfall() {
+    free(_image);
+}
+
+void UIWaterfall::memoryInfo(UIMemoryInfo& m) const {
+    m.type = "UIWaterfall";
+    m.objectBytes = sizeof(*this);
+    if (_image) m.psramBytes += (size_t)_lines * _lineLen * sizeof(uint16_t);
+}
+
+void UIWaterfall::setColorMap(const uint32_t* stops, uint8_t count) {
+    if (!stops || count == 0) {
+        stops = WATERFALL_DEFAULT_MAP;
+        count = sizeof(WATERFALL_DEFAULT_MAP) / sizeof(WATERFALL_DEFAULT_MAP[0]);
+    }
+    for (int i = 0; i < 256; i++) {
+        // Position along the stops in 1/255 steps
+        int pos  = i * (count - 1);
+        int seg  = pos / 255;
+        int frac = pos % 255;
+        uint32_t a = stops[seg];
+        uint32_t b = stops[std::min<int>(seg + 1, count - 1)];
+        auto mix = [&](int shift) {
+            int ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;
+            return (uint8_t)(ca + (cb - ca) * frac / 255);
+        };
+        uint16_t c = lgfx::color565(mix(16), mix(8), mix(0));
+        _lut[i] = (uint16_t)((c >> 8) | (c << 8));
+    }
+}
+
+void UIWaterfall::setRange(float lo, float hi) {
+    if (!(hi > lo)) return;
+    _lo = lo;
+    _hi = hi;
+    _scale = 255.0f / (hi - lo);
+}
+
+void UIWaterfall::setFlow(WaterfallFlow flow) {
+    if (flow == _flow) return;
+    _flow = flow;
+    free(_image);
+    _image = nullptr;
+    invalidate();
+}
+
+void UIWaterfall::clear() {
+    if (_image) {
+        size_t n = (size_t)_lines * _lineLen;
+        for (size_t i = 0; i < n; i++) _image[i] = _lut[0];
+    }
+    _pending = 0;
+    _rows    = 0;
+    invalidate();
+}
+
+// (Re)allocate the ring image for the current size and flow.  A new image
+// starts filled with colour map entry 0.
+bool UIWaterfall::ensureImage() {
+    int16_t lines   = _flow == WaterfallFlow::DOWN ? _h : _w;
+    int16_t lineLen = _flow == WaterfallFlow::DOWN ? _w : _h;
+    if (_image && lines == _lines && lineLen == _lineLen) return true;
+    if (lines <= 0 || lineLen <= 0) return false;
+
+    free(_image);
+    _image = (uint16_t*)allocPixels((size_t)lines * lineLen * sizeof(uint16_t));
+    if (!_image) return false;
+    _lines   = lines;
+    _lineLen = lineLen;
+    _newest  = 0;
+    _pending = 0;
+    _damaged = true;
+    size_t n = (size_t)lines * lineLen;
+    for (size_t i = 0; i < n; i++) _image[i] = _lut[0];
+    return true;
+}
+
+// Claim the oldest line as the newest.  O(1): only the offset moves.
+uint16_t* UIWaterfall::nextLine() {
+    if (!ensureImage()) return nullptr;
+    _newest = (_newest + _lines - 1) % _lines;
+    if (_pending < _lines) _pending++;
+    _rows++;
+    setDirty();
+    return _image + (size_t)_newest * _lineLen;
+}
+
+void UIWaterfall::pushRow(const float* mags, uint16_t bins) {
+    if (!mags || bins == 0) return;
+    uint16_t* line = nextLine();
+    if (!line) return;
+    for (int16_t p = 0; p < _lineLen; p++) {
+        // LEFT lines run top to bottom, with bin 0 at the bottom
+        int32_t  q  = _flow == WaterfallFlow::LEFT ? _lineLen - 1 - p : p;
+        uint32_t b0 = (uint32_t)q * bins / _lineLen;
+        uint32_t b1 = std::max<uint32_t>(b0 + 1, (uint32_t)(q + 1) * bins / _lineLen);
+        float v = -INFINITY;
+        for (uint32_t b = b0; b < b1; b++) {
+            if (mags[b] > v) v = mags[b];          // NaN never wins
+        }
+        float t = (v - _lo) * _scale;
+        line[p] = _lut[t <= 0.0f ? 0 : t >= 255.0f ? 255 : (uint8_t)t];
+    }
+}
+
+void UIWaterfall::pushRow(const uint8_t* levels, uint16_t bins) {
+    if (!levels || bins == 0) return;
+    uint16_t* line = nextLine();
+    if (!line) return;
+    for (int16_t p = 0; p < _lineLen; p++) {
+        int32_t  q  = _flow == WaterfallFlow::LEFT ? _lineLen - 1 - p : p;
+        uint32_t b0 = (uint32_t)q * bins / _lineLen;
+        uint32_t b1 = std::max<uint32_t>(b0 + 1, (uint32_t)(q + 1) * bins / _lineLen);
+        uint8_t v = 0;
+        for (uint32_t b = b0; b < b1; b++) v = std::max(v, levels[b]);
+        line[p] = _lut[v];
+    }
+}
+
+// Push display lines [first, first + n) from the ring: at most two images
+// for DOWN, one 1-pixel column per line for LEFT
+void UIWaterfall::pushLines(LovyanGFX& gfx, int16_t first, int16_t n) {
+    while (n > 0) {
+        int16_t slot = (_newest + first) % _lines;
+        int16_t run  = std::min<int16_t>(n, _lines - slot);
+        const uint16_t* src = _image + (size_t)slot * _lineLen;
+        if (_flow == WaterfallFlow::DOWN) {
+            gfx.pushImage(_x, _y + first, _lineLen, run, (const lgfx::swap565_t*)src);
+        } else {
+            for (int16_t i = 0; i < run; i++) {
+                gfx.pushImage(_x + _w - 1 - (first + i), _y, 1, _lineLen,
+                              (const lgfx::swap565_t*)(src + (size_t)i * _lineLen));
+            }
+        }
+        first += run;
+        n     -= run;
+    }
+}
+
+// Whole image.  LEFT lines are columns, so they are transposed into the
+// shared sprite and pushed once rather than as _w separate columns.
+void UIWaterfall::pushAll(LovyanGFX& gfx) {
+    M5Canvas* spr = _flow == WaterfallFlow::LEFT ? acquireSprite(&gfx, _w, _h) : nullptr;
+    uint16_t* dst = spr ? (uint16_t*)spr->getBuffer() : nullptr;
+    if (!dst) {
+        pushLines(gfx, 0, _lines);
+        return;
+    }
+    for (int16_t x = 0; x < _w; x++) {
+        const uint16_t* col = _image + (size_t)((_newest + _w - 1 - x) % _lines) * _lineLen;
+        for (int16_t y = 0; y < _h; y++) dst[(size_t)y * _w + x] = col[y];
+    }
+    pushTraced(spr, gfx, _x, _y);
+}
+
+void UIWaterfall::draw(LovyanGFX& gfx) {
+    if (!_visible) return;
+    if (!ensureImage()) {
+        gfx.fillRect(_x, _y, _w, _h, rgb888(Tab5Theme::BG_MEDIUM));
+        return;
+    }
+
+    // Scroll in place only while the panel still shows our last frame
+    int16_t k = _pending;
+    _pending = 0;
+    bool full = _damaged || &gfx != _lastTarget || k >= _lines;
+    if (!full) {
+        int32_t cx, cy, cw, ch;
+        gfx.getClipRect(&cx, &cy, &cw, &ch);
+        full = cx > _x || cy > _y || cx + cw < _x + _w || cy + ch < _y + _h;
+    }
+    _damaged    = false;
+    _lastTarget = &gfx;
+
+    if (full) {
+        pushAll(gfx);
+        return;
+    }
+    if (k == 0) return;
+
+    if (_flow == WaterfallFlow::DOWN) gfx.copyRect(_x, _y + k, _w, _h - k, _x, _y);
+    else                              gfx.copyRect(_x, _y, _w - k, _h, _x + k, _y);
+    pushLines(gfx, 0, k);
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  UIGauge
+// ═════════════════════════════════════════════════════════════════════════════
+
+static constexpr float GAUGE_START = 135.0f;   // Min, lower left
+static constexpr float GAUGE_SWEEP = 270.0f;
+
+// fillArc() for a span that may run past 360°
+static void gaugeArc(LovyanGFX& dst, int16_t x, int16_t y, int16_t r0, int16_t r1,
+                     float a0, float a1, uint32_t color) {
+    if (a1 <= 360.0f) {
+        dst.fillArc(x, y, r0, r1, a0, a1, color);
+    } else if (a0 >= 360.0f) {
+        dst.fillArc(x, y, r0, r1, a0 - 360.0f, a1 - 360.0f, color);
+    } else {
+        dst.fillArc(x, y, r0, r1, a0, 360.0f, color);
+        dst.fillArc(x, y, r0, r1, 0.0f, a1 - 360.0f, color);
+    }
+}
+
+UIGauge::UIGauge(int16_t x, int16_t y, int16_t w, int16_t h,
+                 float minVal, float maxVal,
+                 uint32_t needleColor, uint32_t bgColor)
+    : UIElement(x, y, w, h)
+    , _value(minVal)
+    , _min(minVal)
+    , _max(maxVal > minVal ? maxVal : minVal + 1.0f)
+    , _needleColor(needleColor)
+    , _bgColor(bgColor)
+{
+    layout();
+}
+
+UIGauge::~UIGauge() {
+    if (_face) {
+        _face->deleteSprite();
+        delete _face;
+    }
+}
+
+void UIGauge::memoryInfo(UIMemoryInfo& m) const {
+    m.type = "UIGauge";
+    m.objectBytes = sizeof(*this);
+    canvasMemory(m, _face);
+}
+
+void UIGauge::setValue(float v) {
+    v = std::min(_max, std::max(_min, v));
+    if (v == _value) return;
+    _value = v;
+    setDirty();
+}
+
+void UIGauge::setRange(float minVal, float maxVal) {
+    if (!(maxVal > minVal)) return;
+    _min = minVal;
+    _max = maxVal;
+    _value = std::min(_max, std::max(_min, _value));
+    faceDirty();
+}
+
+void UIGauge::setTicks(uint8_t major, uint8_t minor) {
+    _major = std::max<uint8_t>(1, major);
+    _minor = std::max<uint8_t>(1, minor);
+    faceDirty();
+}
+
+void UIGauge::setTitle(const char* title) {
+    strncpy(_title, title ? title : "", sizeof(_title) - 1);
+    _title[sizeof(_title) - 1] = '\0';
+    faceDirty();
+}
+
+bool UIGauge::addZone(float from, float to, uint32_t color) {
+    if (_zoneCount >= TAB5_GAUGE_MAX_ZONES) return false;
+    _zones[_zoneCount++] = { std::min(from, to), std::max(from, to), color };
+    faceDirty();
+    return true;
+}
+
+void UIGauge::clearZones() {
+    _zoneCount = 0;
+    faceDirty();
+}
+
+void UIGauge::setArcColor(uint32_t c) {
+    _arcColor = c;
+    faceDirty();
+}
+
+void UIGauge::setBgColor(uint32_t c) {
+    _bgColor = c;
+    faceDirty();
+}
+
+void UIGauge::setShowValue(bool show) {
+    _showValue = show;
+    setDirty();           // The old readout lies inside the last box
+}
+
+void UIGauge::layout() {
+    _cx = _w / 2;
+    _cy = _h / 2;
+    _r  = std::max<int16_t>(8, std::min(_w, _h) / 2 - 4);
+}
+
+float UIGauge::angleOf(float v) const {
+    float t = (v - _min) / (_max - _min);
+    return GAUGE_START + GAUGE_SWEEP * std::min(1.0f, std::max(0.0f, t));
+}
+
+// Everything that doesn't move with the value
+void UIGauge::drawFace(LovyanGFX& dst, int16_t ox, int16_t oy) {
+    int16_t cx = ox + _cx, cy = oy + _cy;
+    int16_t at = std::max<int16_t>(4, _r / 16);        // Arc thickness
+    int16_t ri = _r - at;
+
+    dst.fillRect(ox, oy, _w, _h, rgb888(_bgColor));
+    gaugeArc(dst, cx, cy, ri, _r, GAUGE_START, GAUGE_START + GAUGE_SWEEP, rgb888(_arcColor));
+    for (int i = 0; i < _zoneCount; i++) {
+        float a0 = angleOf(_zones[i].from), a1 = angleOf(_zones[i].to);
+        if (a1 > a0) gaugeArc(dst, cx, cy, ri, _r, a0, a1, rgb888(_zones[i].color));
+    }
+
+    // Ticks inside the arc; labels inside the major ticks
+    int16_t majorLen = std::max<int16_t>(6, _r / 8);
+    int16_t minorLen = std::max<int16_t>(3, _r / 16);
+    int     steps    = _major * _minor;
+    dst.setTextSize(TAB5_FONT_SIZE_SM);
+    dst.setTextDatum(textdatum_t::middle_center);
+    dst.setTextColor(rgb888(Tab5Theme::TEXT_SECONDARY));
+    int16_t labelR = ri - majorLen - dst.fontHeight();
+    for (int i = 0; i <= steps; i++) {
+        bool  major = i % _minor == 0;
+        float a = (GAUGE_START + GAUGE_SWEEP * i / steps) * (float)M_PI / 180.0f;
+        float c = cosf(a), s = sinf(a);
+        int16_t len = major ? majorLen : minorLen;
+        dst.drawLine(cx + lroundf(c * (ri - 2)),       cy + lroundf(s * (ri - 2)),
+                     cx + lroundf(c * (ri - 2 - len)), cy + lroundf(s * (ri - 2 - len)),
+                     rgb888(major ? Tab5Theme::TEXT_PRIMARY : Tab5Theme::TEXT_SECONDARY));
+        if (major && labelR > 0) {
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%.4g", _min + (_max - _min) * i / steps);
+            dst.drawString(buf, cx + lroundf(c * labelR), cy + lroundf(s * labelR));
+        }
+    }
+
+    if (_title[0]) {
+        dst.drawString(_title, cx, cy + _r / 3);
+    }
+}
+
+// Bounding box of the needle and hub at the current value, plus the
+// readout, padded for rounding and clamped to the widget
+UIGauge::Box UIGauge::dynamicBox() const {
+    float a  = angleOf(_value) * (float)M_PI / 180.0f;
+    float c  = cosf(a), s = sinf(a);
+    float tip  = _r - std::max<int16_t>(4, _r / 16) - 2;
+    float tail = _r / 6.0f;
+    float hub  = std::max(5.0f, _r / 14.0f);
+
+    float x0 = std::min({ c * tip, -c * tail, -hub });
+    float x1 = std::max({ c * tip, -c * tail,  hub });
+    float y0 = std::min({ s * tip, -s * tail, -hub });
+    float y1 = std::max({ s * tip, -s * tail,  hub });
+    Box b = { (int16_t)(_cx + floorf(x0) - 2), (int16_t)(_cy + floorf(y0) - 2),
+              (int16_t)(_cx + ceilf(x1) + 3),  (int16_t)(_cy + ceilf(y1) + 3) };
+    if (_showValue) {
+        int16_t rh = _readoutH;
+        int16_t ry = _cy + _r * 0.6f - rh / 2;
+        b.x0 = std::min<int16_t>(b.x0, _cx - _r / 2);
+        b.x1 = std::max<int16_t>(b.x1, _cx + _r / 2);
+        b.y0 = std::min<int16_t>(b.y0, ry);
+        b.y1 = std::max<int16_t>(b.y1, ry + rh);
+    }
+    b.x0 = std::max<int16_t>(b.x0, 0);
+    b.y0 = std::max<int16_t>(b.y0, 0);
+    b.x1 = std::min<int16_t>(b.x1, _w);
+    b.y1 = std::min<int16_t>(b.y1, _h);
+    return b;
+}
+
+void UIGauge::drawDynamic(LovyanGFX& dst, int16_t ox, int16_t oy) {
+    float a  = angleOf(_value) * (float)M_PI / 180.0f;
+    float c  = cosf(a), s = sinf(a);
+    float tip  = _r - std::max<int16_t>(4, _r / 16) - 2;
+    float tail = _r / 6.0f;
+    float hw   = std::max(2.0f, _r / 40.0f);             // Needle half-width
+    int16_t hub = std::max<int16_t>(5, _r / 14);
+    int16_t cx = ox + _cx, cy = oy + _cy;
+
+    int16_t tx = cx + lroundf(c * tip),  ty = cy + lroundf(s * tip);
+    int16_t lx = cx - lroundf(c * tail), ly = cy - lroundf(s * tail);
+    int16_t bx = lroundf(-s * hw),       by = lroundf(c * hw);
+    uint32_t col = rgb888(_needleColor);
+    dst.fillTriangle(tx, ty, cx + bx, cy + by, cx - bx, cy - by, col);
+    dst.fillTriangle(lx, ly, cx + bx, cy + by, cx - bx, cy - by, col);
+    dst.fillCircle(cx, cy, hub, col);
+    dst.fillCircle(cx, cy, hub / 2, rgb888(_bgColor));
+
+    if (_showValue) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), "%.*f", _decimals, _value);
+        dst.setTextSize(TAB5_FONT_SIZE_MD);
+        dst.setTextDatum(textdatum_t::middle_center);
+        dst.setTextColor(rgb888(Tab5Theme::TEXT_PRIMARY));
+        dst.drawString(buf, cx, oy + _cy + (int16_t)(_r * 0.6f));
+    }
+}
+
+// Render the face into its cached sprite if it is missing, stale or the
+// wrong size.  Without memory for the cache the face is drawn every time.
+bool UIGauge::buildFace(LovyanGFX& gfx) {
+    layout();
+    gfx.setTextSize(TAB5_FONT_SIZE_MD);
+    _readoutH = gfx.fontHeight() + 6;
+    if (_face && (_face->width() != _w || _face->height() != _h)) {
+        _face->deleteSprite();
+        delete _face;
+        _face = nullptr;
+    }
+    if (_face && !_faceStale) return false;
+
+    if (!_face) {
+        _face = new (std::nothrow) M5Canvas(&gfx);
+        if (!_face) return true;
+        _face->setColorDepth(16);
+        _face->setPsram(true);
+        if (!_face->createSprite(_w, _h)) {
+            delete _face;
+            _face = nullptr;
+            return true;
         }
     }
+    _face->setFont(gfx.getFont());
+    drawFace(*_face, 0, 0);
+    _faceStale = false;
+    return true;
+}
 
-    _dragging = false;
-    _wasDrag = false;
-    if (_onRelease) _onRelease(TouchEvent::TOUCH_RELEASE);
+void UIGauge::draw(LovyanGFX& gfx) {
+    if (!_visible) return;
+
+    // Patch only the needle's old and new boxes while the panel still
+    // shows our last frame and the face is unchanged
+    bool full = buildFace(gfx) || _damaged || &gfx != _lastTarget;
+    int32_t cx, cy, cw, ch;
+    gfx.getClipRect(&cx, &cy, &cw, &ch);
+    if (cx > _x || cy > _y || cx + cw < _x + _w || cy + ch < _y + _h) full = true;
+
+    Box nb = dynamicBox();
+    Box r  = full ? Box{ 0, 0, _w, _h }
+                  : Box{ std::min(nb.x0, _lastBox.x0), std::min(nb.y0, _lastBox.y0),
+                         std::max(nb.x1, _lastBox.x1), std::max(nb.y1, _lastBox.y1) };
+    _damaged    = false;
+    _lastTarget = &gfx;
+    _lastBox    = nb;
+    int16_t rw = r.x1 - r.x0, rh = r.y1 - r.y0;
+    if (rw <= 0 || rh <= 0) return;
+
+    M5Canvas* spr = acquireSprite(&gfx, rw, rh);
+    if (spr) {
+        if (_face) _face->pushSprite(spr, -r.x0, -r.y0);
+        else       drawFace(*spr, -r.x0, -r.y0);
+        drawDynamic(*spr, -r.x0, -r.y0);
+        pushTraced(spr, gfx, _x + r.x0, _y + r.y0);
+        return;
+    }
+
+    // No shared sprite: restore the region from the face, then draw the
+    // needle straight onto the target
+    if (_face) {
+        int32_t x0 = std::max<int32_t>(cx, _x + r.x0), y0 = std::max<int32_t>(cy, _y + r.y0);
+        int32_t x1 = std::min<int32_t>(cx + cw, _x + r.x1), y1 = std::min<int32_t>(cy + ch, _y + r.y1);
+        if (x1 <= x0 || y1 <= y0) return;
+        gfx.setClipRect(x0, y0, x1 - x0, y1 - y0);
+        pushTraced(_face, gfx, _x, _y);
+        gfx.setClipRect(cx, cy, cw, ch);
+    } else {
+        drawFace(gfx, _x, _y);
+    }
+    drawDynamic(gfx, _x, _y);
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -5871,7 +8549,9 @@ void UITextArea::handleTouchUp(int16_t tx, int16_t ty) {
 // ═════════════════════════════════════════════════════════════════════════════
 
 UIManager::UIManager(M5GFX& gfx)
-    : _gfx(gfx) {}
+    : _gfx(gfx) {
+    _latency.panel = &gfx;
+}
 
 void UIManager::addElement(UIElement* element) {
     _elements.push_back(element);
@@ -5896,58 +8576,942 @@ void UIManager::clearScreen() {
     _gfx.fillScreen(rgb888(_bgColor));
 }
 
+// ─── Cross-task update queue ─────────────────────────────────────────────────
+// Bounded MPSC ring (Vyukov): each slot's sequence number says whether it
+// is free for the producer at `pos` (seq == pos) or holds a call ready for
+// the consumer (seq == pos + 1).  Producers claim slots with a CAS on
+// `head`; only update() consumes.
+struct PostSlot {
+    std::atomic<uint32_t> seq;
+    void (*apply)(void*);
+    alignas(8) unsigned char closure[TAB5_POST_PAYLOAD];
+};
+
+struct PostQueue {
+    static_assert((TAB5_POST_QUEUE & (TAB5_POST_QUEUE - 1)) == 0,
+                  "TAB5_POST_QUEUE must be a power of two");
+    PostSlot              slots[TAB5_POST_QUEUE];
+    std::atomic<uint32_t> head{0};      // Next slot to claim
+    uint32_t              tail = 0;     // Next slot to apply (UI task only)
+    std::atomic<uint32_t> dropped{0};
+
+    PostQueue() {
+        for (uint32_t i = 0; i < TAB5_POST_QUEUE; i++) slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+};
+static PostQueue _posted;
+
+UIPostString::UIPostString(const char* v) {
+    strncpy(s, v ? v : "", sizeof(s) - 1);
+    s[sizeof(s) - 1] = '\0';
+}
+
+bool UIManager::postRaw(void (*apply)(void*), const void* closure, size_t bytes) {
+    uint32_t pos = _posted.head.load(std::memory_order_relaxed);
+    PostSlot* slot;
+    for (;;) {
+        slot = &_posted.slots[pos & (TAB5_POST_QUEUE - 1)];
+        uint32_t seq = slot->seq.load(std::memory_order_acquire);
+        int32_t  dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (_posted.head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (dif < 0) {
+            _posted.dropped.fetch_add(1, std::memory_order_relaxed);   // Full
+            return false;
+        } else {
+            pos = _posted.head.load(std::memory_order_relaxed);
+        }
+    }
+    memcpy(slot->closure, closure, bytes);
+    slot->apply = apply;
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Calls a plain function queued by post(fn, arg)
+struct PostFnClosure {
+    void (*fn)(void*);
+    void* arg;
+    static void apply(void* p) {
+        PostFnClosure* c = static_cast<PostFnClosure*>(p);
+        c->fn(c->arg);
+    }
+};
+
+bool UIManager::post(void (*fn)(void* arg), void* arg) {
+    if (!fn) return false;
+    PostFnClosure c{ fn, arg };
+    return postRaw(&PostFnClosure::apply, &c, sizeof(c));
+}
+
+uint32_t UIManager::getPostDropped() const {
+    return _posted.dropped.load(std::memory_order_relaxed);
+}
+
+void UIManager::applyPosted() {
+    // At most one queue's worth per frame, so a busy producer can't hold
+    // the UI task here
+    for (int n = 0; n < TAB5_POST_QUEUE; n++) {
+        PostSlot& slot = _posted.slots[_posted.tail & (TAB5_POST_QUEUE - 1)];
+        uint32_t seq = slot.seq.load(std::memory_order_acquire);
+        if ((int32_t)(seq - (_posted.tail + 1)) < 0) break;   // Empty
+        slot.apply(slot.closure);
+        slot.seq.store(_posted.tail + TAB5_POST_QUEUE, std::memory_order_release);
+        _posted.tail++;
+    }
+}
+
+void UIManager::beginUpdate() {
+    _batchDepth++;
+}
+
+void UIManager::endUpdate() {
+    uint16_t depth = _batchDepth.load();
+    while (depth > 0 && !_batchDepth.compare_exchange_weak(depth, depth - 1)) {}
+    if (depth != 1) return;   // Unbalanced, or still nested
+
+    // Drawing here could race update() on the UI task; leave it to update()
+    _flushPending.store(true);
+}
+
 void UIManager::drawAll() {
+    if (_batchDepth.load() > 0 || _frameBudgetUs) {
+        // Progressive first paint (what doesn't fit is left to update()),
+        // or held until endUpdate()
+        for (auto* elem : _elements) {
+            if (elem->isVisible()) elem->invalidate();
+        }
+        drawDirty();
+        return;
+    }
     _gfx.startWrite();
+    restoreClosedOverlays();
     for (auto* elem : _elements) {
         if (elem->isVisible()) {
-            elem->draw(_gfx);
+            elem->invalidate();
+            drawElement(_gfx, elem);
             elem->setDirty(false);
         }
     }
     _gfx.endWrite();
 }
 
+void UIManager::restoreClosedOverlays() {
+#if TAB5_SAVE_UNDER
+    // Restore in reverse so stacked overlays unwind in the right order
+    for (int i = SAVE_UNDER_SLOTS - 1; i >= 0; --i) {
+        SaveUnder& s = _saveUnders[i];
+        if (!s.owner || isOverlayOpen(s.owner)) continue;
+
+        const UIElement* owner = s.owner;
+        int16_t dx = s.dmgX0, dy = s.dmgY0;
+        int16_t dw = s.dmgX1 - s.dmgX0, dh = s.dmgY1 - s.dmgY0;
+        restoreSaveUnder(_gfx, s);
+
+        // Widgets that changed while covered are repainted over the blit
+        if (dw > 0 && dh > 0) invalidateArea(dx, dy, dw, dh, owner);
+    }
+#endif
+}
+
+void UIManager::invalidateArea(int16_t x, int16_t y, int16_t w, int16_t h,
+                               const UIElement* except) {
+    for (auto* e : _elements) {
+        if (e == except || !e->isVisible()) continue;
+        if (!rectsOverlap(e->getX(), e->getY(), e->getWidth(), e->getHeight(),
+                          x, y, w, h)) continue;
+        if (e->isContainer()) {
+            static_cast<UIContainer*>(e)->invalidateRect(x, y, w, h);
+        } else {
+            e->invalidate();
+        }
+    }
+}
+
 void UIManager::drawDirty() {
+    if (_batchDepth.load() > 0) return;   // Held until endUpdate()
+#if TAB5_STATS
+    uint32_t t0 = micros();
+#endif
     _gfx.startWrite();
-    bool anyDrawn = false;
+    restoreClosedOverlays();
+    if (_redraw.panel) eraseRedrawOutlines();
+
+    _schedule.active   = true;
+    _schedule.t0       = micros();
+    _schedule.budgetUs = _frameBudgetUs;
+    _schedule.carried  = 0;
+    _schedule.backgroundWaiting = false;
+    // An early feedback draw may have covered the HUD
+    bool anyDrawn = _feedbackDrawn;
+    _feedbackDrawn = false;
+
+    // The touched widget first, if update() could not draw it early
     for (auto* elem : _elements) {
-        if (!elem->isVisible()) continue;
-
-        if (elem->isTabView()) {
-            UITabView* tv = static_cast<UITabView*>(elem);
-            if (tv->isDirty()) {
-                // Full redraw (page switch, tab bar change, etc.)
-                tv->draw(_gfx);
-                tv->setDirty(false);
-                anyDrawn = true;
-            } else if (tv->hasActiveDirtyChild()) {
-                // Partial redraw — only dirty children, no background clear
-                tv->drawDirtyChildren(_gfx);
-                anyDrawn = true;
-            }
-        } else if (elem->isDirty()) {
-            elem->draw(_gfx);
+        if (elem == _schedule.interactive && elem->isVisible() && elem->isDirty() &&
+            !elem->isContainer()) {
+            drawElement(_gfx, elem);
             elem->setDirty(false);
             anyDrawn = true;
         }
     }
 
-    // If anything was redrawn and a modal overlay (keyboard, popup, menu) is
-    // visible and dirty, redraw it on top so it isn't covered by a widget
-    // that painted over its area (e.g. a UITextArea that extends beneath
-    // the keyboard).  Only redraw if the overlay is actually dirty —
-    // unconditional redraws cause a flash on every keystroke.
-    if (anyDrawn) {
+    // Overlays with a save-under snapshot next: content drawn after them
+    // is clipped around them, so they can go ahead of it
+    for (auto* elem : _elements) {
+        if (!elem->isVisible() || !elem->isDirty()) continue;
+        if (elem->getRedrawPriority() != RedrawPriority::OVERLAY || !hasSaveUnder(elem)) continue;
+        drawElement(_gfx, elem);
+        elem->setDirty(false);
+        anyDrawn = true;
+    }
+
+    // Content, then BACKGROUND widgets if any were held back for it
+    for (uint8_t tier = (uint8_t)RedrawPriority::CONTENT;
+         tier <= (uint8_t)RedrawPriority::BACKGROUND; tier++) {
+        if (tier == (uint8_t)RedrawPriority::BACKGROUND && !_schedule.backgroundWaiting) break;
+        _schedule.tier = tier;
         for (auto* elem : _elements) {
-            if (!elem->isVisible() || !elem->isDirty()) continue;
-            if (elem->isKeyboard() || elem->isPopup() || elem->isMenu()) {
-                elem->draw(_gfx);
+            if (!elem->isVisible()) continue;
+            if (elem->getRedrawPriority() == RedrawPriority::OVERLAY) continue;
+
+            if (elem->isContainer()) {
+                UIContainer* c = static_cast<UIContainer*>(elem);
+                if (c->isDirty()) {
+                    // Full redraw (page switch, tab bar change, etc.)
+                    if (scheduleDefers(c)) continue;
+                    drawElement(_gfx, c);
+                    c->setDirty(false);
+                    anyDrawn = true;
+                } else if (c->hasDirtyChild()) {
+                    // Partial redraw — only dirty descendants, no background
+                    // clear.  O(1) check thanks to dirty-bit propagation.
+                    c->drawDirtyChildren(_gfx);
+                    anyDrawn = true;
+                }
+            } else if (elem->isDirty()) {
+                if (scheduleDefers(elem)) continue;
+                drawElement(_gfx, elem);
                 elem->setDirty(false);
+                anyDrawn = true;
             }
         }
     }
+    _schedule.active      = false;
+    _schedule.interactive = nullptr;
 
+    // Remaining dirty overlays (keyboard, popup, menu) go on top, so a
+    // widget that painted over their area (e.g. a UITextArea that extends
+    // beneath the keyboard) doesn't cover them.  Only dirty ones are
+    // drawn — unconditional redraws cause a flash on every keystroke.
+    for (auto* elem : _elements) {
+        if (!elem->isVisible() || !elem->isDirty()) continue;
+        if (elem->getRedrawPriority() == RedrawPriority::OVERLAY) {
+            drawElement(_gfx, elem);
+            elem->setDirty(false);
+            anyDrawn = true;
+        }
+    }
+
+    if (_redraw.panel) drawRedrawOutlines();
+    if (_overdraw.panel && _overdraw.recorded) endOverdrawPass();
+
+    // Stats HUD on top of everything; refreshed when something may have
+    // painted over it, and twice a second otherwise
+    if (_hudOn && (anyDrawn || uiMillis() - _hudLastMs >= 500)) drawHud();
+
+    _gfx.endWrite();
+
+#if TAB5_STATS
+    if (_stats.enabled && _stats.frameDirty > 0) {
+        _stats.r->drawUs.add(micros() - t0);
+        _stats.r->pixels.add(_stats.framePixels);
+        _stats.r->dirty.add(_stats.frameDirty);
+    }
+#endif
+}
+
+int UIManager::getCarriedRedraws() const {
+    return _schedule.carried;
+}
+
+bool UIManager::isRedrawPending() const {
+    for (auto* elem : _elements) {
+        if (!elem->isVisible()) continue;
+        if (elem->isDirty()) return true;
+        if (elem->isContainer() && static_cast<UIContainer*>(elem)->hasDirtyChild()) return true;
+    }
+    return false;
+}
+
+void UIManager::drawFeedback(UIElement* e) {
+    if (_batchDepth.load() > 0) return;
+    if (e->isContainer() || !e->isVisible() || !e->isDirty()) return;
+
+    // Clip to every enclosing container's child area.  A container that
+    // repaints in full this pass would cover the early draw anyway.
+    int32_t cx0 = 0, cy0 = 0;
+    int32_t cx1 = Tab5UI::screenW(), cy1 = Tab5UI::screenH();
+    UIElement* root = e;
+    for (UIContainer* p = e->getParent(); p; p = p->getParent()) {
+        if (!p->isVisible() || p->isDirty()) return;
+        int16_t ax, ay, aw, ah;
+        p->getChildArea(ax, ay, aw, ah);
+        cx0 = std::max<int32_t>(cx0, ax);
+        cy0 = std::max<int32_t>(cy0, ay);
+        cx1 = std::min<int32_t>(cx1, ax + aw);
+        cy1 = std::min<int32_t>(cy1, ay + ah);
+        root = p;
+    }
+    if (cx1 <= cx0 || cy1 <= cy0) return;
+    if (std::find(_elements.begin(), _elements.end(), root) == _elements.end()) return;
+
+    // A widget partly beneath an open overlay (e.g. a text area under the
+    // keyboard) needs drawDirty()'s overlay repaint afterwards
+    for (auto* o : _elements) {
+        if (o == root || !o->isVisible()) continue;
+        if (!(o->isKeyboard() || o->isPopup() || o->isMenu())) continue;
+        if (rectsOverlap(o->getX(), o->getY(), o->getWidth(), o->getHeight(),
+                         e->getX(), e->getY(), e->getWidth(), e->getHeight())) return;
+    }
+
+    _gfx.startWrite();
+    int32_t px, py, pw, ph;
+    _gfx.getClipRect(&px, &py, &pw, &ph);
+    _gfx.setClipRect(cx0, cy0, cx1 - cx0, cy1 - cy0);
+    drawElement(_gfx, e);
+    e->setDirty(false);
+    _gfx.setClipRect(px, py, pw, ph);
     _gfx.endWrite();
+    _feedbackDrawn = true;
+}
+
+// ─── Redraw-region overlay ───────────────────────────────────────────────────
+
+void UIManager::setRedrawOverlay(bool show) {
+    // Take every outline down and repaint whatever it was covering
+    if (!show && _redraw.panel) eraseRedrawOutlines(true);
+    _redraw.panel = show ? &_gfx : nullptr;
+    _redraw.count = 0;
+    _redraw.depth = 0;
+    _redraw.mute  = false;
+}
+
+bool UIManager::isRedrawOverlay() const {
+    return _redraw.panel != nullptr;
+}
+
+// Outline of a region plus its counter label
+static void redrawOutlineRects(const RedrawRegion& rg, int16_t r[5][4]) {
+    const int16_t t = 2;
+    int16_t lw = std::min<int16_t>(rg.w, 64);
+    int16_t lh = std::min<int16_t>(rg.h, 22);
+    int16_t rects[5][4] = {
+        { rg.x, rg.y, rg.w, t },                         // Top
+        { rg.x, (int16_t)(rg.y + rg.h - t), rg.w, t },   // Bottom
+        { rg.x, rg.y, t, rg.h },                         // Left
+        { (int16_t)(rg.x + rg.w - t), rg.y, t, rg.h },   // Right
+        { rg.x, rg.y, lw, lh },                          // Counter label
+    };
+    memcpy(r, rects, sizeof(rects));
+}
+
+// Take down outlines older than REDRAW_OUTLINE_MS (or all of them): clear
+// them to the background and repaint the widgets beneath.  The repaint is
+// not itself recorded, or the overlay would keep outlining its own erasures.
+void UIManager::eraseRedrawOutlines(bool all) {
+    unsigned long now = uiMillis();
+    bool erased = false;
+    for (int i = 0; i < _redraw.count; i++) {
+        RedrawRegion& rg = _redraw.regions[i];
+        if (!rg.shown || (!all && now - rg.shownMs < REDRAW_OUTLINE_MS)) continue;
+        int16_t r[5][4];
+        redrawOutlineRects(rg, r);
+        for (auto& q : r) _gfx.fillRect(q[0], q[1], q[2], q[3], rgb888(_bgColor));
+        invalidateArea(rg.x, rg.y, rg.w, rg.h);
+        rg.shown = false;
+        erased = true;
+    }
+    _redraw.mute = erased;
+}
+
+// Outline every region written this pass — green once, yellow twice, red
+// three or more times — with its running total, and redraw the outlines
+// still on screen in case this pass painted over them.
+void UIManager::drawRedrawOutlines() {
+    bool repaint = _redraw.recorded || _redraw.mute;
+    _redraw.mute = false;
+    _redraw.recorded = false;
+    if (!repaint) return;
+
+    static const uint32_t LEVEL_COLORS[] = { 0x00E676, 0xFFD600, 0xFF1744 };
+    unsigned long now = uiMillis();
+    _gfx.setTextSize(1.0f);
+    _gfx.setTextDatum(textdatum_t::top_left);
+    for (int i = 0; i < _redraw.count; i++) {
+        RedrawRegion& rg = _redraw.regions[i];
+        if (rg.frameHits > 0) {
+            rg.level   = std::min<uint16_t>(rg.frameHits, 3);
+            rg.shown   = true;
+            rg.shownMs = now;
+            rg.frameHits = 0;
+        }
+        if (!rg.shown) continue;
+
+        uint32_t color = rgb888(LEVEL_COLORS[rg.level - 1]);
+        int16_t r[5][4];
+        redrawOutlineRects(rg, r);
+        for (int k = 0; k < 4; k++) _gfx.fillRect(r[k][0], r[k][1], r[k][2], r[k][3], color);
+        char label[12];
+        snprintf(label, sizeof(label), "%lu", (unsigned long)rg.total);
+        _gfx.fillRect(r[4][0], r[4][1], r[4][2], r[4][3], rgb888(0x000000));
+        _gfx.setTextColor(color);
+        _gfx.drawString(label, rg.x + 4, rg.y + 2);
+    }
+}
+
+// ─── Allocation tracking ─────────────────────────────────────────────────────
+
+UIAllocStats UIManager::getAllocStats() const {
+    UIAllocStats st;
+#if TAB5_ALLOC_HOOKED
+    st.tracking    = true;
+    st.frames      = _allocStats.frames;
+    st.allocFrames = _allocStats.allocFrames;
+    st.allocs      = _allocStats.allocs;
+    st.frees       = _allocStats.frees;
+    st.bytes       = _allocStats.bytes;
+    st.maxAllocs   = _allocStats.maxAllocs;
+    st.lastAllocs  = _allocStats.lastAllocs;
+#endif
+    return st;
+}
+
+void UIManager::resetAllocStats() {
+#if TAB5_ALLOC_HOOKED
+    _allocStats = AllocState{};
+#endif
+}
+
+// ─── Overdraw tracking ───────────────────────────────────────────────────────
+
+bool UIManager::setOverdrawTracking(bool enable) {
+    if (enable && !_overdraw.cur) {
+        uint16_t cx = (Tab5UI::screenW() + TAB5_OVERDRAW_CELL - 1) / TAB5_OVERDRAW_CELL;
+        uint16_t cy = (Tab5UI::screenH() + TAB5_OVERDRAW_CELL - 1) / TAB5_OVERDRAW_CELL;
+        _overdraw.cur  = new (std::nothrow) uint8_t[cx * cy]();
+        _overdraw.peak = new (std::nothrow) uint8_t[cx * cy]();
+        if (!_overdraw.cur || !_overdraw.peak) {
+            delete[] _overdraw.cur;
+            delete[] _overdraw.peak;
+            _overdraw.cur = _overdraw.peak = nullptr;
+            return false;
+        }
+        _overdraw.cellsX = cx;
+        _overdraw.cellsY = cy;
+    }
+    _overdraw.panel = enable ? &_gfx : nullptr;
+    return true;
+}
+
+bool UIManager::isOverdrawTracking() const {
+    return _overdraw.panel != nullptr;
+}
+
+void UIManager::resetOverdraw() {
+    if (!_overdraw.cur) return;
+    size_t n = (size_t)_overdraw.cellsX * _overdraw.cellsY;
+    memset(_overdraw.cur, 0, n);
+    memset(_overdraw.peak, 0, n);
+    _overdraw.frames = _overdraw.lastCells = _overdraw.lastPaints = 0;
+    _overdraw.recorded = false;
+}
+
+// Fold the pass into the peak map and start the next one
+void UIManager::endOverdrawPass() {
+    size_t n = (size_t)_overdraw.cellsX * _overdraw.cellsY;
+    uint32_t cells = 0, paints = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t c = _overdraw.cur[i];
+        if (!c) continue;
+        cells++;
+        paints += c;
+        if (c > _overdraw.peak[i]) _overdraw.peak[i] = c;
+    }
+    memset(_overdraw.cur, 0, n);
+    _overdraw.lastCells  = cells;
+    _overdraw.lastPaints = paints;
+    _overdraw.frames++;
+    _overdraw.recorded = false;
+}
+
+UIOverdrawStats UIManager::getOverdrawStats() const {
+    UIOverdrawStats st;
+    if (!_overdraw.peak) return st;
+    st.frames      = _overdraw.frames;
+    st.cellSize    = TAB5_OVERDRAW_CELL;
+    st.cellsX      = _overdraw.cellsX;
+    st.cellsY      = _overdraw.cellsY;
+    st.lastCells   = _overdraw.lastCells;
+    st.lastAvg     = _overdraw.lastCells
+                   ? (float)_overdraw.lastPaints / _overdraw.lastCells : 0.0f;
+    size_t n = (size_t)_overdraw.cellsX * _overdraw.cellsY;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t c = _overdraw.peak[i];
+        if (c > st.peakMax) st.peakMax = c;
+        if (c >= 3) st.hotCells++;
+    }
+    return st;
+}
+
+void UIManager::dumpOverdrawHeatmap(Print& out) const {
+    if (!_overdraw.peak) return;
+    // Plain-text PPM, one pixel per cell: black = never painted, then
+    // blue (1), green (2), yellow (3), orange (4) and red (5+)
+    static const uint8_t HEAT[6][3] = {
+        {   0,   0,   0 }, {  30,  60, 200 }, {  40, 180,  60 },
+        { 240, 220,  40 }, { 250, 140,  20 }, { 230,  30,  30 },
+    };
+    char buf[24];   // Fits the longest header, "P3\n65535 65535\n255\n"
+    snprintf(buf, sizeof(buf), "P3\n%u %u\n255\n",
+             (unsigned)_overdraw.cellsX, (unsigned)_overdraw.cellsY);
+    out.print(buf);
+    for (uint16_t cy = 0; cy < _overdraw.cellsY; cy++) {
+        for (uint16_t cx = 0; cx < _overdraw.cellsX; cx++) {
+            const uint8_t* c = HEAT[std::min<int>(_overdraw.peak[cy * _overdraw.cellsX + cx], 5)];
+            snprintf(buf, sizeof(buf), "%u %u %u ", c[0], c[1], c[2]);
+            out.print(buf);
+        }
+        out.print("\n");
+    }
+}
+
+// ─── Render statistics ───────────────────────────────────────────────────────
+
+void UIManager::setStatsEnabled(bool enable) {
+#if TAB5_STATS
+    if (enable && !_stats.r) {
+        _stats.r = new (std::nothrow) StatsRings();
+        if (!_stats.r) return;
+    }
+    _stats.enabled = enable;
+#else
+    (void)enable;
+#endif
+}
+
+bool UIManager::isStatsEnabled() const {
+#if TAB5_STATS
+    return _stats.enabled;
+#else
+    return false;
+#endif
+}
+
+UIStats UIManager::getStats() const {
+    UIStats st;
+#if TAB5_STATS
+    if (!_stats.r) return st;
+    st.frames       = _stats.frames;
+    st.frameUs      = _stats.r->frameUs.summary();
+    st.drawUs       = _stats.r->drawUs.summary();
+    st.touchUs      = _stats.r->touchUs.summary();
+    st.pixels       = _stats.r->pixels.summary();
+    st.bytes.min    = st.pixels.min * 2;
+    st.bytes.avg    = st.pixels.avg * 2;
+    st.bytes.p99    = st.pixels.p99 * 2;
+    st.dirty        = _stats.r->dirty.summary();
+    st.spriteAllocs = _stats.spriteAllocs;
+    st.tagCount     = _stats.tagCount;
+    for (int i = 0; i < _stats.tagCount; i++) {
+        memcpy(st.tags[i].tag, _stats.r->tags[i].tag, sizeof(st.tags[i].tag));
+        st.tags[i].drawUs = _stats.r->tags[i].drawUs.summary();
+    }
+#endif
+    return st;
+}
+
+void UIManager::resetStats() {
+#if TAB5_STATS
+    // Field by field — a StatsRings temporary would be several KB of stack
+    if (_stats.r) {
+        StatRing* rings[] = { &_stats.r->frameUs, &_stats.r->drawUs, &_stats.r->touchUs,
+                              &_stats.r->pixels, &_stats.r->dirty };
+        for (auto* r : rings) r->count = r->head = 0;
+    }
+    _stats.frames = 0;
+    _stats.spriteAllocs = 0;
+    _stats.tagCount = 0;
+#endif
+}
+
+void UIManager::setStatsHud(bool show, HudCorner corner) {
+#if TAB5_STATS
+    if (_hudOn && (!show || corner != _hudCorner)) {
+        // Repaint whatever the old HUD box was covering
+        int16_t x, y, w, h;
+        hudRect(x, y, w, h);
+        invalidateArea(x, y, w, h);
+    }
+    _hudOn = show;
+    _hudCorner = corner;
+    _hudLastMs = 0;
+    if (show) setStatsEnabled(true);
+#else
+    (void)show; (void)corner;
+#endif
+}
+
+void UIManager::hudRect(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+    w = 300;
+    h = 112;
+    bool right  = _hudCorner == HudCorner::TOP_RIGHT || _hudCorner == HudCorner::BOTTOM_RIGHT;
+    bool bottom = _hudCorner == HudCorner::BOTTOM_LEFT || _hudCorner == HudCorner::BOTTOM_RIGHT;
+    x = right  ? Tab5UI::screenW() - w - 4 : 4;
+    y = bottom ? Tab5UI::screenH() - h - 4 : 4;
+}
+
+void UIManager::drawHud() {
+#if TAB5_STATS
+    if (!_stats.r) return;   // Ring allocation failed
+    _hudLastMs = uiMillis();
+    int16_t x, y, w, h;
+    hudRect(x, y, w, h);
+
+    // Drawn directly: the box is small, and borrowing the shared sprite
+    // would resize it every frame and skew the reallocation count
+    LovyanGFX& dst = _gfx;
+    int16_t ox = x;
+    int16_t oy = y;
+
+    dst.fillRect(ox, oy, w, h, rgb888(0x000000));
+    dst.drawRect(ox, oy, w, h, rgb888(Tab5Theme::BORDER));
+    dst.setTextSize(1.0f);
+    dst.setTextDatum(textdatum_t::top_left);
+    dst.setTextColor(rgb888(Tab5Theme::ACCENT));
+
+    UIStat f = _stats.r->frameUs.summary();
+    UIStat d = _stats.r->drawUs.summary();
+    UIStat t = _stats.r->touchUs.summary();
+    UIStat p = _stats.r->pixels.summary();
+    UIStat n = _stats.r->dirty.summary();
+    char line[48];
+    int16_t ly = oy + 6;
+    snprintf(line, sizeof(line), "frame %5.1f avg %5.1f p99 ms",
+             f.avg / 1000.0f, f.p99 / 1000.0f);
+    dst.drawString(line, ox + 8, ly);  ly += 20;
+    snprintf(line, sizeof(line), "draw  %5.1f avg %5.1f p99 ms",
+             d.avg / 1000.0f, d.p99 / 1000.0f);
+    dst.drawString(line, ox + 8, ly);  ly += 20;
+    snprintf(line, sizeof(line), "touch %5lu avg %5lu p99 us",
+             (unsigned long)t.avg, (unsigned long)t.p99);
+    dst.drawString(line, ox + 8, ly);  ly += 20;
+    snprintf(line, sizeof(line), "px/f  %5luk avg %5luk p99",
+             (unsigned long)(p.avg / 1000), (unsigned long)(p.p99 / 1000));
+    dst.drawString(line, ox + 8, ly);  ly += 20;
+    snprintf(line, sizeof(line), "dirty %3lu avg %3lu p99  alloc %lu",
+             (unsigned long)n.avg, (unsigned long)n.p99,
+             (unsigned long)_stats.spriteAllocs);
+    dst.drawString(line, ox + 8, ly);
+#endif
+}
+
+// ─── Event tracing ───────────────────────────────────────────────────────────
+
+bool UIManager::setTraceEnabled(bool enable, size_t events) {
+#if TAB5_TRACE
+    if (enable && (!_trace.ring || _trace.cap != events)) {
+        _trace.enabled = false;
+        delete[] _trace.ring;
+        _trace.ring = events ? new (std::nothrow) TraceEvent[events] : nullptr;
+        _trace.cap  = _trace.ring ? events : 0;
+        _trace.head = _trace.count = 0;
+        if (!_trace.ring) return false;
+    }
+    _trace.enabled = enable;
+    return true;
+#else
+    (void)enable; (void)events;
+    return false;
+#endif
+}
+
+bool UIManager::isTraceEnabled() const {
+#if TAB5_TRACE
+    return _trace.enabled;
+#else
+    return false;
+#endif
+}
+
+void UIManager::clearTrace() {
+#if TAB5_TRACE
+    _trace.head = _trace.count = 0;
+#endif
+}
+
+#if TAB5_TRACE
+// JSON string body (quotes and backslashes escaped, controls dropped)
+static void traceWriteString(Print& out, const char* str) {
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') out.print('\\');
+        if ((uint8_t)*str >= 0x20) out.print(*str);
+    }
+}
+#endif
+
+void UIManager::dumpTrace(Print& out) const {
+#if TAB5_TRACE
+    // Spans are written oldest first; tracing pauses while dumping
+    bool wasEnabled = _trace.enabled;
+    _trace.enabled = false;
+
+    out.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    size_t start = (_trace.head + _trace.cap - _trace.count) % std::max<size_t>(_trace.cap, 1);
+    char buf[96];
+    for (size_t i = 0; i < _trace.count; i++) {
+        const TraceEvent& ev = _trace.ring[(start + i) % _trace.cap];
+        // Draws and callbacks are named after their element so the
+        // timeline shows which widget a span belongs to
+        bool byTag = ev.cat == TraceCat::DRAW && ev.tag;
+        const char* name = byTag && ev.tag[0] ? ev.tag : ev.name;
+        out.print(i ? ",\n{\"name\":\"" : "{\"name\":\"");
+        traceWriteString(out, name ? name : "-");
+        snprintf(buf, sizeof(buf),
+                 "\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                 "\"ts\":%lu,\"dur\":%lu,\"args\":{",
+                 TRACE_CAT_NAMES[(int)ev.cat], (unsigned long)ev.ts,
+                 (unsigned long)ev.dur);
+        out.print(buf);
+        if (ev.tag && ev.tag[0]) {
+            out.print("\"tag\":\"");
+            traceWriteString(out, ev.tag);
+            out.print(ev.arg ? "\"," : "\"");
+        }
+        if (ev.arg) {
+            snprintf(buf, sizeof(buf), "\"%s\":%lu",
+                     ev.cat == TraceCat::PUSH ? "pixels" :
+                     ev.cat == TraceCat::SORT ? "rows" : "chars",
+                     (unsigned long)ev.arg);
+            out.print(buf);
+        }
+        out.print("}}");
+    }
+    out.print("\n]}\n");
+
+    _trace.enabled = wasEnabled;
+#else
+    (void)out;
+#endif
+}
+
+// ─── Callback deferral & watchdog ────────────────────────────────────────────
+
+void UIManager::setDeferredCallbacks(bool defer) {
+    _callbacks.defer = defer;
+}
+
+bool UIManager::isDeferredCallbacks() const {
+    return _callbacks.defer;
+}
+
+void UIManager::setCallbackBudget(uint32_t us) {
+    _callbacks.budgetUs = us;
+}
+
+uint32_t UIManager::getCallbackBudget() const {
+    return _callbacks.budgetUs;
+}
+
+void UIManager::setOnCallbackOverrun(CallbackOverrunHandler handler) {
+    _callbacks.onOverrun = handler;
+}
+
+int UIManager::getCallbackOverruns(UICallbackOverrun* out, int max) const {
+    for (int i = 0; out && i < _callbacks.overrunCount && i < max; i++) out[i] = _callbacks.overruns[i];
+    return _callbacks.overrunCount;
+}
+
+void UIManager::resetCallbackOverruns() {
+    _callbacks.overrunCount = 0;
+}
+
+void UIManager::callbackReport(Print& out) const {
+    char line[96];
+    snprintf(line, sizeof(line), "Tab5UI callbacks over budget (%lu us)\n",
+             (unsigned long)_callbacks.budgetUs);
+    out.print(line);
+    for (int i = 0; i < _callbacks.overrunCount; i++) {
+        const UICallbackOverrun& o = _callbacks.overruns[i];
+        snprintf(line, sizeof(line), "  %-20s %-14s %6lux  last %7.1f ms  worst %7.1f ms\n",
+                 o.tag, o.name, (unsigned long)o.count, o.lastUs / 1000.0, o.worstUs / 1000.0);
+        out.print(line);
+    }
+    if (_callbacks.overrunCount == 0) out.print("  (none)\n");
+}
+
+// ─── Touch-to-photon latency ─────────────────────────────────────────────────
+
+void UIManager::setLatencyTracking(bool enable) {
+    _latency.enabled = enable;
+}
+
+bool UIManager::isLatencyTracking() const {
+    return _latency.enabled;
+}
+
+int UIManager::getLatencyStats(UILatencyHist* out, int max) const {
+    for (int i = 0; out && i < _latency.typeCount && i < max; i++) out[i] = _latency.types[i];
+    return _latency.typeCount;
+}
+
+void UIManager::resetLatency() {
+    _latency.typeCount = 0;
+}
+
+void UIManager::latencyReport(Print& out) const {
+    char line[128];
+    out.print("Tab5UI touch-to-photon latency (ms, to last panel write)\n");
+    int n = snprintf(line, sizeof(line), "  %-16s %6s %7s %7s ", "type", "count", "mean", "max");
+    for (int b = 0; b < TAB5_LATENCY_BUCKETS && n < (int)sizeof(line); b++) {
+        if (b < TAB5_LATENCY_BUCKETS - 1) {
+            n += snprintf(line + n, sizeof(line) - n, " <%-4u", TAB5_LATENCY_BOUNDS_MS[b]);
+        } else {
+            n += snprintf(line + n, sizeof(line) - n, " %5s", "more");
+        }
+    }
+    out.print(line);
+    out.print("\n");
+
+    for (int i = 0; i < _latency.typeCount; i++) {
+        const UILatencyHist& h = _latency.types[i];
+        n = snprintf(line, sizeof(line), "  %-16s %6lu %7.1f %7.1f ", h.type,
+                     (unsigned long)h.count,
+                     h.count ? (double)h.totalUs / h.count / 1000.0 : 0.0,
+                     h.maxUs / 1000.0);
+        for (int b = 0; b < TAB5_LATENCY_BUCKETS && n < (int)sizeof(line); b++) {
+            n += snprintf(line + n, sizeof(line) - n, " %5lu", (unsigned long)h.buckets[b]);
+        }
+        out.print(line);
+        out.print("\n");
+    }
+    if (_latency.typeCount == 0) out.print("  (no samples)\n");
+}
+
+// ─── Memory report ───────────────────────────────────────────────────────────
+
+struct MemoryRow {
+    const char* type;
+    uint32_t    count;
+    size_t      objectBytes, heapBytes, psramBytes;
+};
+static constexpr int MEMORY_MAX_TYPES = 32;
+
+// Add an element and its subtree to the per-type rows.  Children that live
+// inside their parent object (UITabView's page containers) already count
+// in the parent's size.
+static void memoryWalk(const UIElement* e, const char* ownerLo, const char* ownerHi,
+                       MemoryRow* rows, int& rowCount) {
+    UIMemoryInfo m;
+    e->memoryInfo(m);
+    const char* self = (const char*)e;
+    const char* end  = self + m.objectBytes;
+    if (self >= ownerLo && self < ownerHi) m.objectBytes = 0;
+
+    MemoryRow* row = nullptr;
+    for (int i = 0; i < rowCount; i++) {
+        if (strcmp(rows[i].type, m.type) == 0) { row = &rows[i]; break; }
+    }
+    if (!row && rowCount < MEMORY_MAX_TYPES) {
+        row = &rows[rowCount++];
+        *row = MemoryRow{ m.type, 0, 0, 0, 0 };
+    }
+    if (row) {
+        row->count++;
+        row->objectBytes += m.objectBytes;
+        row->heapBytes   += m.heapBytes;
+        row->psramBytes  += m.psramBytes;
+    }
+
+    if (!e->isContainer()) return;
+    const UIContainer* c = static_cast<const UIContainer*>(e);
+    for (int i = 0; i < c->childCount(); i++) {
+        memoryWalk(c->getChild(i), self, end, rows, rowCount);
+    }
+}
+
+void UIManager::memoryReport(Print& out) const {
+    MemoryRow rows[MEMORY_MAX_TYPES];
+    int rowCount = 0;
+    for (const UIElement* e : _elements) memoryWalk(e, nullptr, nullptr, rows, rowCount);
+    std::sort(rows, rows + rowCount, [](const MemoryRow& a, const MemoryRow& b) {
+        return a.objectBytes + a.heapBytes + a.psramBytes >
+               b.objectBytes + b.heapBytes + b.psramBytes;
+    });
+
+    char line[96];
+    out.print("Tab5UI memory (bytes)\n");
+    snprintf(line, sizeof(line), "  %-20s %5s %9s %9s %9s\n",
+             "type", "count", "object", "heap", "psram");
+    out.print(line);
+    MemoryRow total = { "total", 0, 0, 0, 0 };
+    for (int i = 0; i < rowCount; i++) {
+        const MemoryRow& rw = rows[i];
+        snprintf(line, sizeof(line), "  %-20s %5lu %9lu %9lu %9lu\n", rw.type,
+                 (unsigned long)rw.count, (unsigned long)rw.objectBytes,
+                 (unsigned long)rw.heapBytes, (unsigned long)rw.psramBytes);
+        out.print(line);
+        total.count       += rw.count;
+        total.objectBytes += rw.objectBytes;
+        total.heapBytes   += rw.heapBytes;
+        total.psramBytes  += rw.psramBytes;
+    }
+    snprintf(line, sizeof(line), "  %-20s %5lu %9lu %9lu %9lu\n", total.type,
+             (unsigned long)total.count, (unsigned long)total.objectBytes,
+             (unsigned long)total.heapBytes, (unsigned long)total.psramBytes);
+    out.print(line);
+
+    // ── Shared buffers ──
+    UIMemoryInfo shared;
+    if (_sharedSprite) shared.heapBytes = sizeof(M5Canvas);
+    shared.psramBytes = _spriteCap;
+    size_t saveUnderHeap = 0, saveUnderPsram = 0;
+#if TAB5_SAVE_UNDER
+    for (const auto& su : _saveUnders) {
+        UIMemoryInfo m;
+        canvasMemory(m, su.buf);
+        saveUnderHeap  += m.heapBytes;
+        saveUnderPsram += m.psramBytes;
+    }
+#endif
+    size_t iconHeap = 0, iconPsram = 0;
+#if TAB5_RENDER_MODE != 2
+    for (const auto& ic : _icons) {
+        if (!ic.spr) continue;
+        iconHeap  += sizeof(M5Canvas);
+        iconPsram += ic.cap;
+    }
+#endif
+    struct { const char* name; size_t heap, psram; } extras[] = {
+        { "UIManager element list", _elements.capacity() * sizeof(UIElement*), 0 },
+        { "shared sprite",          shared.heapBytes, shared.psramBytes },
+        { "save-under buffers",     saveUnderHeap, saveUnderPsram },
+        { "icon cache",             iconHeap, iconPsram },
+#if TAB5_STATS
+        { "render stats",           _stats.r ? sizeof(StatsRings) : 0, 0 },
+#endif
+#if TAB5_TRACE
+        { "trace ring",             _trace.cap * sizeof(TraceEvent), 0 },
+#endif
+        { "overdraw maps",          _overdraw.cur ? 2u * _overdraw.cellsX * _overdraw.cellsY : 0, 0 },
+        { "touch log",              _recLog ? sizeof(UITouchLogHeader) + _recMax * sizeof(UITouchEvent) : 0, 0 },
+    };
+    out.print("  shared:\n");
+    for (const auto& x : extras) {
+        snprintf(line, sizeof(line), "  %-26s %9s %9lu %9lu\n", x.name, "",
+                 (unsigned long)x.heap, (unsigned long)x.psram);
+        out.print(line);
+    }
 }
 
 UIElement* UIManager::findByTag(const char* tag) {
@@ -5959,7 +9523,7 @@ UIElement* UIManager::findByTag(const char* tag) {
 
 void UIManager::setSleepTimeout(uint32_t minutes) {
     _sleepTimeoutMin = minutes;
-    _lastActivityTime = millis();
+    _lastActivityTime = uiMillis();
 }
 
 void UIManager::setBrightness(uint8_t b) {
@@ -5975,18 +9539,19 @@ void UIManager::wake() {
     if (!_screenAsleep) return;
     _screenAsleep = false;
     _gfx.setBrightness(_brightness);
-    _lastActivityTime = millis();
-    if (_onWake) _onWake();
+    _lastActivityTime = uiMillis();
+    fireCallback(nullptr, "onWake", _onWake);
 }
 
 void UIManager::sleep() {
     if (_screenAsleep) return;
     _screenAsleep = true;
     _gfx.setBrightness(0);
-    if (_onSleep) _onSleep();
+    fireCallback(nullptr, "onSleep", _onSleep);
 
 #if defined(ESP32)
-    if (_lightSleepEnabled) {
+    // Polls the panel directly, so not with an injected touch source
+    if (_lightSleepEnabled && !_touchSource) {
         // ── Low-power idle with touch-to-wake ──
         // The backlight is already off (the dominant power draw).
         // We poll getTouch() which internally checks the GT911 INT pin
@@ -6013,11 +9578,202 @@ void UIManager::sleep() {
 #endif
 }
 
+void UIManager::setClock(ClockSource clock) {
+    _uiClock = clock;
+}
+
+bool UIManager::readTouch(int16_t& x, int16_t& y) {
+    bool down;
+    if (_touchSource) {
+        down = _touchSource(x, y);
+    } else {
+        lgfx::touch_point_t tp;
+        down = _gfx.getTouch(&tp, 1) > 0;
+        if (down) {
+            x = (int16_t)tp.x;
+            y = (int16_t)tp.y;
+        }
+    }
+    if (_recActive) recordTouch(down, x, y);
+    return down;
+}
+
+// ─── Touch session recording & replay ────────────────────────────────────────
+
+static constexpr char     TOUCH_LOG_MAGIC[4]  = { 'T', '5', 'T', 'L' };
+static constexpr uint16_t TOUCH_LOG_VERSION   = 1;
+
+bool UIManager::startTouchRecording(size_t maxEvents) {
+    stopTouchRecording();
+    delete[] _recLog;
+    _recLog = new (std::nothrow) uint8_t[sizeof(UITouchLogHeader) +
+                                         maxEvents * sizeof(UITouchEvent)];
+    if (!_recLog) {
+        _recMax = 0;
+        return false;
+    }
+    UITouchLogHeader hdr;
+    memcpy(hdr.magic, TOUCH_LOG_MAGIC, sizeof(hdr.magic));
+    hdr.version   = TOUCH_LOG_VERSION;
+    hdr.eventSize = sizeof(UITouchEvent);
+    hdr.count     = 0;
+    memcpy(_recLog, &hdr, sizeof(hdr));
+
+    _recMax    = maxEvents;
+    _recActive = true;
+    _recDown   = false;
+    _recX = _recY = -1;
+    _recStart  = uiMillis();
+    return true;
+}
+
+void UIManager::stopTouchRecording() {
+    _recActive = false;
+}
+
+const uint8_t* UIManager::getTouchLog(size_t& bytes) const {
+    if (!_recLog) {
+        bytes = 0;
+        return nullptr;
+    }
+    UITouchLogHeader hdr;
+    memcpy(&hdr, _recLog, sizeof(hdr));
+    bytes = sizeof(hdr) + hdr.count * sizeof(UITouchEvent);
+    return _recLog;
+}
+
+// Append an event when the touch state or position changed
+void UIManager::recordTouch(bool down, int16_t x, int16_t y) {
+    if (!down) x = y = -1;
+    if (down == _recDown && x == _recX && y == _recY) return;
+
+    UITouchLogHeader hdr;
+    memcpy(&hdr, _recLog, sizeof(hdr));
+    if (hdr.count >= _recMax) {
+        _recActive = false;   // Full — keep what we have
+        return;
+    }
+    UITouchEvent ev;
+    ev.ms = (uint32_t)(uiMillis() - _recStart);
+    ev.x  = x;
+    ev.y  = y;
+    memcpy(_recLog + sizeof(hdr) + hdr.count * sizeof(ev), &ev, sizeof(ev));
+    hdr.count++;
+    memcpy(_recLog, &hdr, sizeof(hdr));
+
+    _recDown = down;
+    _recX = x;
+    _recY = y;
+}
+
+UIReplayReport UIManager::replayTouchLog(const uint8_t* log, size_t bytes,
+                                         uint16_t frameMs) {
+    UIReplayReport rep;
+    UITouchLogHeader hdr;
+    if (!log || bytes < sizeof(hdr) || frameMs == 0) return rep;
+    memcpy(&hdr, log, sizeof(hdr));
+    if (memcmp(hdr.magic, TOUCH_LOG_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != TOUCH_LOG_VERSION ||
+        hdr.eventSize != sizeof(UITouchEvent) ||
+        hdr.count > (bytes - sizeof(hdr)) / sizeof(UITouchEvent)) {
+        return rep;
+    }
+    const uint8_t* events = log + sizeof(hdr);
+    auto eventAt = [events](uint32_t i) {
+        UITouchEvent ev;
+        memcpy(&ev, events + i * sizeof(ev), sizeof(ev));
+        return ev;
+    };
+
+    // Play until the last event, then let animations settle
+    uint32_t endMs  = (hdr.count ? eventAt(hdr.count - 1).ms : 0) + 500;
+    uint32_t frames = endMs / frameMs + 1;
+    uint32_t* frameUs    = new (std::nothrow) uint32_t[frames];
+    uint32_t* dispatchUs = new (std::nothrow) uint32_t[frames];
+    if (!frameUs || !dispatchUs) {
+        delete[] frameUs;
+        delete[] dispatchUs;
+        return rep;
+    }
+
+    // Swap in the virtual clock and log-driven touch source.  Events are
+    // consumed only when update() actually reads touch (not while it is
+    // debouncing), one per read, so no press or release is skipped.
+    bool wasRecording = _recActive;
+    stopTouchRecording();
+    TouchSource savedTouch = _touchSource;
+    ClockSource savedClock = _uiClock;
+
+    unsigned long vclock = 0;
+    uint32_t next = 0;
+    bool     down = false;
+    int16_t  curX = -1, curY = -1;
+    _uiClock = [&vclock]() { return vclock; };
+    _touchSource = [&](int16_t& x, int16_t& y) {
+        if (next < hdr.count && eventAt(next).ms <= vclock) {
+            UITouchEvent ev = eventAt(next++);
+            down = ev.x >= 0;
+            curX = ev.x;
+            curY = ev.y;
+        }
+        x = curX;
+        y = curY;
+        return down;
+    };
+    _lastTouchTime    = 0;
+    _lastActivityTime = 0;
+    _hudLastMs        = 0;
+
+    uint32_t dispatches = 0;
+    uint32_t worstUs    = 0;
+    for (uint32_t f = 0; f < frames; f++, vclock += frameMs) {
+        _lastDispatchUs = 0;
+        uint32_t t0 = micros();
+        update();
+        uint32_t us = micros() - t0;
+        frameUs[f] = us;
+        if (_lastDispatchUs) dispatchUs[dispatches++] = _lastDispatchUs;
+        if (us > (uint32_t)frameMs * 1000) rep.dropped++;
+        if (us > worstUs) {
+            worstUs = us;
+            rep.worstFrame = f;
+        }
+    }
+
+    // Lift a finger left down at the end of the log
+    if (down) {
+        down = false;
+        vclock += TOUCH_DEBOUNCE_MS;
+        update();
+    }
+
+    _touchSource      = savedTouch;
+    _uiClock          = savedClock;
+    _lastTouchTime    = 0;
+    _lastActivityTime = uiMillis();
+    _hudLastMs        = 0;
+    if (wasRecording) _recActive = true;
+
+    rep.ok         = true;
+    rep.events     = next;
+    rep.frames     = frames;
+    rep.frameUs    = summarizeSamples(frameUs, frames);
+    rep.dispatchUs = summarizeSamples(dispatchUs, dispatches);
+    delete[] frameUs;
+    delete[] dispatchUs;
+    return rep;
+}
+
 void UIManager::update() {
+    AllocFrameScope allocScope;
+
+    // Changes posted by other tasks land before this frame draws
+    applyPosted();
+
     // Lazy-init content bottom from runtime screen height
     if (_contentBottom == 0) _contentBottom = Tab5UI::screenH();
 
-    unsigned long now = millis();
+    unsigned long now = uiMillis();
 
     // ── Screen sleep timeout check ──
     if (_sleepTimeoutMin > 0 && !_screenAsleep) {
@@ -6033,6 +9789,17 @@ void UIManager::update() {
 
     if (now - _lastTouchTime < TOUCH_DEBOUNCE_MS) return;
 
+    uint32_t frameT0 = micros();
+#if TAB5_TRACE
+    uint32_t traceMark = _trace.total;
+#endif
+#if TAB5_STATS
+    _stats.framePixels = 0;
+    _stats.frameDirty  = 0;
+#endif
+    bool dispatched = false;
+    CallbackDeferScope deferScope;
+
     // Check if any modal overlay is open (keyboard, menu, or popup) — it gets exclusive touch priority
     UIElement* modalElem = nullptr;
     for (auto* elem : _elements) {
@@ -6043,15 +9810,15 @@ void UIManager::update() {
         }
     }
 
-    lgfx::touch_point_t tp;
-    uint_fast8_t count = _gfx.getTouch(&tp, 1);
+    int16_t tx = 0, ty = 0;
+    bool touched = readTouch(tx, ty);
+    uint32_t  sampleUs     = micros();
+    uint32_t  sampleSeq    = _latency.writeSeq;
+    const char* latencyType = nullptr;   // Widget type the input landed on
 
     bool modalJustClosed = false;
 
-    if (count > 0) {
-        int16_t tx = (int16_t)tp.x;
-        int16_t ty = (int16_t)tp.y;
-
+    if (touched) {
         // If the screen is asleep, wake it and consume this touch
         if (_screenAsleep) {
             wake();
@@ -6097,6 +9864,7 @@ void UIManager::update() {
                     _touchedElem = modalElem;
                     modalElem->handleTouchDown(tx, ty);
                 }
+                dispatched = true;
             } else {
                 // Normal hit-testing (reverse for z-order)
                 for (int i = (int)_elements.size() - 1; i >= 0; --i) {
@@ -6110,15 +9878,21 @@ void UIManager::update() {
                     if (hit) {
                         _touchedElem = elem;
                         elem->handleTouchDown(tx, ty);
+                        dispatched = true;
                         break;
                     }
                 }
             }
             _wasTouched = true;
+            latencyType   = latencyTypeOf(_touchedElem);
+            _feedbackElem = touchedLeaf(_touchedElem);
         } else if (_touchedElem) {
             // Sustained touch — dispatch move event
             if (tx != _lastTouchX || ty != _lastTouchY) {
                 _touchedElem->handleTouchMove(tx, ty);
+                dispatched = true;
+                latencyType   = latencyTypeOf(_touchedElem);
+                _feedbackElem = touchedLeaf(_touchedElem);
             }
         }
 
@@ -6130,15 +9904,21 @@ void UIManager::update() {
         if (_wasTouched && _touchedElem) {
             bool wasModal = (_touchedElem->isMenu() || _touchedElem->isKeyboard() || _touchedElem->isPopup())
                           && _touchedElem->isVisible();
+            // Before the release clears the container's touched child
+            latencyType   = latencyTypeOf(_touchedElem);
+            _feedbackElem = touchedLeaf(_touchedElem);
             _touchedElem->handleTouchUp(_lastTouchX, _lastTouchY);
+            dispatched = true;
 
             // If a modal overlay just closed, erase its footprint and
-            // mark overlapping elements dirty.  Avoid marking the TabView
-            // container itself dirty — that would trigger UITabView::draw()
-            // which clears the entire content area with fillRect, causing a
+            // mark overlapping elements dirty.  Avoid marking containers
+            // themselves dirty — that would trigger a full draw() which
+            // clears the entire content area with fillRect, causing a
             // visible flash.  Instead, drawDirtyChildren() will repaint only
             // the affected children without a background clear.
-            if (wasModal && !_touchedElem->isVisible()) {
+            // With a save-under buffer the footprint is blitted back by
+            // restoreClosedOverlays() at the start of drawDirty() instead.
+            if (wasModal && !_touchedElem->isVisible() && !hasSaveUnder(_touchedElem)) {
                 // Begin a batched write so the erase + subsequent dirty
                 // redraws arrive as one display transaction (no flash).
                 _gfx.startWrite();
@@ -6150,34 +9930,28 @@ void UIManager::update() {
                 int16_t mw = _touchedElem->getWidth() + 4;  // shadow offset
                 int16_t mh = _touchedElem->getHeight() + 4;
                 _gfx.fillRect(mx, my, mw, mh, rgb888(_bgColor));
+                redrawRecord(_gfx, mx, my, mw, mh);
+                overdrawRecord(_gfx, mx, my, mw, mh);
 
                 // Mark elements that overlap the modal footprint as dirty
                 for (auto* e : _elements) {
                     if (!e->isVisible()) continue;
-                    // For TabViews, mark overlapping children dirty (not the
-                    // TabView itself) so drawDirtyChildren() handles them.
-                    if (e->isTabView()) {
-                        UITabView* tv = static_cast<UITabView*>(e);
-                        int ap = tv->getActivePage();
-                        if (ap >= 0) {
-                            int cc = tv->getChildCount(ap);
-                            for (int ci = 0; ci < cc; ci++) {
-                                UIElement* child = tv->getChild(ap, ci);
-                                if (child && child->isVisible()) {
-                                    // Check overlap with modal footprint
-                                    int16_t cx = child->getX();
-                                    int16_t cy = child->getY();
-                                    int16_t cw = child->getWidth();
-                                    int16_t ch = child->getHeight();
-                                    if (cx < mx + mw && cx + cw > mx &&
-                                        cy < my + mh && cy + ch > my) {
-                                        child->setDirty(true);
-                                    }
-                                }
-                            }
+                    // For containers, mark overlapping descendants dirty
+                    // (not the container itself) so drawDirtyChildren()
+                    // handles them.  Subtrees outside the footprint are
+                    // culled by bounding box.
+                    if (e->isContainer()) {
+                        int16_t ex = e->getX();
+                        int16_t ey = e->getY();
+                        int16_t ew = e->getWidth();
+                        int16_t eh = e->getHeight();
+                        if (ex < mx + mw && ex + ew > mx &&
+                            ey < my + mh && ey + eh > my) {
+                            UIContainer* c = static_cast<UIContainer*>(e);
+                            c->invalidateRect(mx, my, mw, mh);
+                            // Redraw decoration (e.g. tab bar) cheaply
+                            c->drawChrome(_gfx);
                         }
-                        // Redraw the tab bar cheaply (no fillRect flash)
-                        tv->drawTabBar(_gfx);
                     } else if (e != _touchedElem) {
                         int16_t ex = e->getX();
                         int16_t ey = e->getY();
@@ -6185,7 +9959,7 @@ void UIManager::update() {
                         int16_t eh = e->getHeight();
                         if (ex < mx + mw && ex + ew > mx &&
                             ey < my + mh && ey + eh > my) {
-                            e->setDirty(true);
+                            e->invalidate();
                         }
                     }
                 }
@@ -6197,12 +9971,62 @@ void UIManager::update() {
         // re-touch for fast keyboard typing without debounce delay.
     }
 
-    // Redraw dirty elements
-    drawDirty();
+    deferScope.end();
+    _lastDispatchUs = dispatched ? std::max<uint32_t>(1, micros() - frameT0) : 0;
+#if TAB5_TRACE
+    if (dispatched) traceRecord(TraceCat::DISPATCH, "dispatch", nullptr, frameT0, _lastDispatchUs);
+#endif
+#if TAB5_STATS
+    if (_stats.enabled && dispatched) _stats.r->touchUs.add(_lastDispatchUs);
+#endif
+
+    // Pressed-state feedback first, then everything else that is dirty
+    if (_feedbackElem) {
+        _schedule.interactive = _feedbackElem;
+        drawFeedback(_feedbackElem);
+        _feedbackElem = nullptr;
+    }
+
+    // Redraw dirty elements.  After a batch ends, everything it touched
+    // goes out in this one pass, whatever the frame budget.
+    if (_flushPending.load() && _batchDepth.load() == 0) {
+        _flushPending.store(false);
+        uint32_t budget = _frameBudgetUs;
+        _frameBudgetUs = 0;
+        drawDirty();
+        _frameBudgetUs = budget;
+    } else {
+        drawDirty();
+    }
 
     // End the batched write started during modal close so erase + redraws
     // are flushed to the display as a single transaction.
     if (modalJustClosed) {
         _gfx.endWrite();
+        notePanelWrite(_gfx);
+    }
+
+    // Input that reached the panel this pass: sample → last write
+    if (latencyType && _latency.writeSeq != sampleSeq) {
+        latencyRecord(latencyType, _latency.writeEndUs - sampleUs);
+    }
+
+    // Deferred callbacks run now that the feedback is on screen; show
+    // whatever they changed in the same pass
+    if (_callbacks.queued > 0 && drainDeferredCallbacks() > 0) {
+        drawDirty();
+    }
+
+#if TAB5_STATS
+    if (_stats.enabled && (dispatched || _stats.frameDirty > 0)) {
+        _stats.r->frameUs.add(micros() - frameT0);
+        _stats.frames++;
+    }
+#endif
+#if TAB5_TRACE
+    // Enclosing span for any frame that did work
+    if (_trace.total != traceMark) {
+        traceRecord(TraceCat::FRAME, "update", nullptr, frameT0, micros() - frameT0);
     }
+#endif
 }
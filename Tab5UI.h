@@ -17,6 +17,10 @@
 #include <M5GFX.h>
 #include <vector>
 #include <functional>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 // ─── Runtime Screen Dimensions ──────────────────────────────────────────────
 // Call Tab5UI::init(gfx) once in setup() to read the actual display size.
@@ -37,6 +41,108 @@ namespace Tab5UI {
 #define TAB5_RENDER_MODE 0
 #endif
 
+// ─── Save-Under Buffers ─────────────────────────────────────────────────────
+// When enabled, menus, popups, the keyboard and open dropdown lists copy the
+// pixels beneath them into a PSRAM buffer when first drawn, and UIManager
+// blits them back in one transfer when the overlay closes (instead of
+// erasing to the background and repainting every overlapped widget).
+//   1 = enabled (default unless TAB5_RENDER_MODE is 2)
+//   0 = disabled — erase and repaint on close
+#ifndef TAB5_SAVE_UNDER
+#if TAB5_RENDER_MODE == 2
+#define TAB5_SAVE_UNDER 0
+#else
+#define TAB5_SAVE_UNDER 1
+#endif
+#endif
+
+// ─── Render Statistics ──────────────────────────────────────────────────────
+// Compiles in UIManager::getStats() and the performance HUD.  Collection is
+// off until enabled at runtime: until then the cost is a few dozen bytes of
+// counters and one flag check per draw.  The sample rings (~8 KB) are only
+// allocated on the first setStatsEnabled(true).  Define as 0 to compile it
+// out entirely.
+#ifndef TAB5_STATS
+#define TAB5_STATS 1
+#endif
+#define TAB5_STATS_WINDOW    64    // Rolling window (frames) for min/avg/p99
+#define TAB5_STATS_MAX_TAGS  24    // Distinct element tags tracked
+
+// ─── Event Tracing ──────────────────────────────────────────────────────────
+// Compiles in UIManager::setTraceEnabled() / dumpTrace().  Like the stats,
+// tracing is off until enabled at runtime; the ring of TAB5_TRACE_EVENTS
+// spans (~24 bytes each) is only allocated then.  Define as 0 to compile
+// it out entirely.
+#ifndef TAB5_TRACE
+#define TAB5_TRACE 1
+#endif
+#ifndef TAB5_TRACE_EVENTS
+#define TAB5_TRACE_EVENTS    2048
+#endif
+
+// ─── Allocation Tracking (debug) ─────────────────────────────────────────────
+// Set to 1 to count heap allocations made during UIManager::update()
+// (see UIManager::getAllocStats).  Tab5UI.cpp is compiled on its own, so
+// this has to be a build flag (-DTAB5_ALLOC_TRACK=1 in build_opt.h or
+// PlatformIO build_flags); a #define in the sketch doesn't reach it.
+// Counting uses the ESP-IDF heap hooks and needs an IDF built with
+// CONFIG_HEAP_USE_HOOKS; without them getAllocStats() reports
+// tracking = false.  Counts are process-wide, so allocations by other
+// tasks during update() are included.
+#ifndef TAB5_ALLOC_TRACK
+#define TAB5_ALLOC_TRACK 0
+#endif
+
+// ─── Icon Cache ─────────────────────────────────────────────────────────────
+// PNG icons (UIIconButton, UIColumnList icon cells) are decoded once per
+// size and background colour into a PSRAM slot of this many, then blitted.
+// Raise it if a screen shows more distinct icon/background pairs than this.
+// Not used when TAB5_RENDER_MODE is 2, where icons are decoded every draw.
+#ifndef TAB5_ICON_CACHE
+#define TAB5_ICON_CACHE      32
+#endif
+
+// ─── Overdraw Tracking ──────────────────────────────────────────────────────
+// Cell size (pixels, square) of UIManager's overdraw heatmap.  The two
+// per-cell counters cost 2 bytes per cell, ~29 KB at 8 px on 1280×720.
+#ifndef TAB5_OVERDRAW_CELL
+#define TAB5_OVERDRAW_CELL   8
+#endif
+
+// ─── Touch Session Recording ────────────────────────────────────────────────
+// Default capacity of UIManager::startTouchRecording(), in events (8 bytes
+// each).  Only changes are logged, so 4096 events is several minutes of use.
+#ifndef TAB5_TOUCH_LOG_MAX
+#define TAB5_TOUCH_LOG_MAX   4096
+#endif
+
+// ─── Callback Watchdog & Deferral ───────────────────────────────────────────
+// Default budget (µs) of UIManager::setCallbackBudget(): a user callback
+// that runs longer is reported with its element tag.  With
+// setDeferredCallbacks(true), callbacks fired by touch handling wait in a
+// queue of TAB5_CALLBACK_QUEUE entries (~32 bytes each) until the pass's
+// feedback has been drawn; if it fills up, callbacks run immediately.
+#ifndef TAB5_CALLBACK_BUDGET_US
+#define TAB5_CALLBACK_BUDGET_US 20000
+#endif
+#ifndef TAB5_CALLBACK_QUEUE
+#define TAB5_CALLBACK_QUEUE  32
+#endif
+#define TAB5_CALLBACK_MAX_OVERRUNS 16   // Distinct tag/callback pairs reported
+
+// ─── Cross-Task Update Queue ────────────────────────────────────────────────
+// Slots in UIManager::post()'s queue (a power of two) and the bytes each
+// can carry: target, setter and arguments, with string arguments copied
+// in (at most TAB5_POST_STR_MAX - 1 characters).  The queue is static,
+// ~3 KB at the defaults.
+#ifndef TAB5_POST_QUEUE
+#define TAB5_POST_QUEUE      32
+#endif
+#ifndef TAB5_POST_STR_MAX
+#define TAB5_POST_STR_MAX    48
+#endif
+#define TAB5_POST_PAYLOAD    (TAB5_POST_STR_MAX + 32)
+
 // ─── Default Screen Constants (landscape 1280×720) ─────────────────────────
 #define TAB5_SCREEN_W   1280
 #define TAB5_SCREEN_H   720
@@ -67,7 +173,6 @@ namespace Tab5UI {
 #define TAB5_LIST_SCROLLBAR_W 6     // Scrollbar width
 #define TAB5_TAB_BAR_H      48      // Tab bar height
 #define TAB5_TAB_MAX_PAGES  8       // Max pages in a tab view
-#define TAB5_TAB_MAX_CHILDREN 36    // Max child elements per page
 #define TAB5_FONT_SIZE_SM   1.4f    // Small text
 #define TAB5_FONT_SIZE_MD   1.8f    // Medium text (labels, buttons)
 #define TAB5_FONT_SIZE_LG   2.4f    // Large text (title bar)
@@ -108,8 +213,25 @@ enum class TouchEvent {
 // ─── Callback Signature ─────────────────────────────────────────────────────
 using TouchCallback = std::function<void(TouchEvent event)>;
 
-// Forward declaration
+// ─── Redraw priority (see UIManager::setFrameBudget) ───────────────────────
+enum class RedrawPriority : uint8_t {
+    INTERACTIVE,   // Widget under the finger (assigned by UIManager)
+    OVERLAY,       // Keyboard, menus, popups (automatic)
+    CONTENT,       // Default
+    BACKGROUND     // Clocks, readouts, charts: drawn last, first to wait
+};
+
+// Forward declarations
 class UIManager;
+class UIContainer;
+
+// ─── Memory footprint of one element (see UIManager::memoryReport) ─────────
+struct UIMemoryInfo {
+    const char* type        = "UIElement";
+    size_t      objectBytes = 0;   // sizeof the object itself
+    size_t      heapBytes   = 0;   // Internal-RAM buffers it owns
+    size_t      psramBytes  = 0;   // PSRAM buffers it owns (sprite caches)
+};
 
 /*******************************************************************************
  * UIElement — Abstract base class for all UI widgets
@@ -117,7 +239,7 @@ class UIManager;
 class UIElement {
 public:
     UIElement(int16_t x, int16_t y, int16_t w, int16_t h);
-    virtual ~UIElement() = default;
+    virtual ~UIElement();   // Drops any deferred callbacks / feedback it queued
 
     // ── Drawing ──
     virtual void draw(LovyanGFX& gfx) = 0;
@@ -152,10 +274,32 @@ public:
     virtual bool isKeyboard() const   { return false; }
     virtual bool isPopup() const      { return false; }
     virtual bool isTabView() const    { return false; }
+    virtual bool isContainer() const  { return false; }
+
+    // ── Memory footprint ── (see UIManager::memoryReport)
+    virtual void memoryInfo(UIMemoryInfo& m) const;
 
     // ── Dirty flag (needs redraw) ──
-    void setDirty(bool d = true) { _dirty = d; }
+    // Marking an element dirty also flags every ancestor container, so a
+    // container can tell in O(1) whether anything beneath it needs drawing.
+    void setDirty(bool d = true);
     bool isDirty() const         { return _dirty; }
+    // Dirty because something else painted over the element (an overlay
+    // erase, a container clearing its background), so its last output is
+    // gone from the panel.  Widgets that update the panel incrementally
+    // (UIChart) repaint in full after this.
+    void invalidate()            { _damaged = true; setDirty(); }
+
+    // ── Redraw priority ──
+    // Order within a drawDirty() pass and what waits for the next pass when
+    // the frame budget runs out.  Overlays always report OVERLAY.
+    void setRedrawPriority(RedrawPriority p) { _priority = p; }
+    RedrawPriority getRedrawPriority() const {
+        return (isKeyboard() || isMenu() || isPopup()) ? RedrawPriority::OVERLAY : _priority;
+    }
+
+    // ── Hierarchy ──
+    UIContainer* getParent() const { return _parent; }
 
     // ── Tag for identification ──
     void setTag(const char* tag) { _tag = tag; }
@@ -167,10 +311,15 @@ protected:
     bool     _enabled  = true;
     bool     _pressed  = false;
     bool     _dirty    = true;
+    bool     _damaged  = true;    // See invalidate()
+    RedrawPriority _priority = RedrawPriority::CONTENT;
     const char* _tag   = "";
+    UIContainer* _parent = nullptr;   // Set by UIContainer::addChild()
 
     TouchCallback _onTouch   = nullptr;
     TouchCallback _onRelease = nullptr;
+
+    friend class UIContainer;
 };
 
 /*******************************************************************************
@@ -184,15 +333,16 @@ public:
             float textSize = TAB5_FONT_SIZE_MD);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UILabel"; m.objectBytes = sizeof(*this); }
 
     void setText(const char* text);
     const char* getText() const { return _text; }
 
-    void setTextColor(uint32_t color) { _textColor = color; _dirty = true; }
-    void setTextSize(float s)         { _textSize = s; _dirty = true; }
-    void setBgColor(uint32_t color)   { _bgColor = color; _hasBg = true; _dirty = true; }
-    void clearBgColor()               { _hasBg = false; _dirty = true; }
-    void setAlign(textdatum_t datum)  { _align = datum; _dirty = true; }
+    void setTextColor(uint32_t color) { _textColor = color; setDirty(); }
+    void setTextSize(float s)         { _textSize = s; setDirty(); }
+    void setBgColor(uint32_t color)   { _bgColor = color; _hasBg = true; setDirty(); }
+    void clearBgColor()               { _hasBg = false; setDirty(); }
+    void setAlign(textdatum_t datum)  { _align = datum; setDirty(); }
 
 private:
     char     _text[128];
@@ -215,18 +365,19 @@ public:
              float textSize     = TAB5_FONT_SIZE_MD);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIButton"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
     void setLabel(const char* label);
     const char* getLabel() const { return _label; }
 
-    void setBgColor(uint32_t c)      { _bgColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)      { _bgColor = c; setDirty(); }
     void setPressedColor(uint32_t c)  { _pressedColor = c; }
-    void setTextColor(uint32_t c)     { _textColor = c; _dirty = true; }
-    void setTextSize(float s)         { _textSize = s; _dirty = true; }
-    void setCornerRadius(int16_t r)   { _radius = r; _dirty = true; }
-    void setBorderColor(uint32_t c)   { _borderColor = c; _hasBorder = true; _dirty = true; }
+    void setTextColor(uint32_t c)     { _textColor = c; setDirty(); }
+    void setTextSize(float s)         { _textSize = s; setDirty(); }
+    void setCornerRadius(int16_t r)   { _radius = r; setDirty(); }
+    void setBorderColor(uint32_t c)   { _borderColor = c; _hasBorder = true; setDirty(); }
 
 private:
     char     _label[64];
@@ -262,19 +413,20 @@ public:
                  float textSize     = TAB5_FONT_SIZE_MD);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIIconButton"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
     void setLabel(const char* label);
     const char* getLabel() const { return _label; }
 
-    void setIcon(const uint8_t* data, uint32_t size) { _iconData = data; _iconSize = size; _dirty = true; }
-    void setBgColor(uint32_t c)      { _bgColor = c; _dirty = true; }
+    void setIcon(const uint8_t* data, uint32_t size) { _iconData = data; _iconSize = size; setDirty(); }
+    void setBgColor(uint32_t c)      { _bgColor = c; setDirty(); }
     void setPressedColor(uint32_t c)  { _pressedColor = c; }
-    void setTextColor(uint32_t c)     { _textColor = c; _dirty = true; }
-    void setTextSize(float s)         { _textSize = s; _dirty = true; }
-    void setCornerRadius(int16_t r)   { _radius = r; _dirty = true; }
-    void setBorderColor(uint32_t c)   { _borderColor = c; _hasBorder = true; _dirty = true; }
+    void setTextColor(uint32_t c)     { _textColor = c; setDirty(); }
+    void setTextSize(float s)         { _textSize = s; setDirty(); }
+    void setCornerRadius(int16_t r)   { _radius = r; setDirty(); }
+    void setBorderColor(uint32_t c)   { _borderColor = c; _hasBorder = true; setDirty(); }
 
 private:
     char           _label[64];
@@ -311,6 +463,7 @@ public:
              uint32_t thumbColor  = Tab5Theme::TEXT_PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UISlider"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -323,16 +476,16 @@ public:
     int  getMax() const { return _maxVal; }
 
     // Appearance
-    void setTrackColor(uint32_t c) { _trackColor = c; _dirty = true; }
-    void setFillColor(uint32_t c)  { _fillColor = c; _dirty = true; }
-    void setThumbColor(uint32_t c) { _thumbColor = c; _dirty = true; }
-    void setThumbRadius(int16_t r) { _thumbR = r; _dirty = true; }
-    void setShowValue(bool show)   { _showValue = show; _dirty = true; }
+    void setTrackColor(uint32_t c) { _trackColor = c; setDirty(); }
+    void setFillColor(uint32_t c)  { _fillColor = c; setDirty(); }
+    void setThumbColor(uint32_t c) { _thumbColor = c; setDirty(); }
+    void setThumbRadius(int16_t r) { _thumbR = r; setDirty(); }
+    void setShowValue(bool show)   { _showValue = show; setDirty(); }
 
     // Optional label (drawn above the track)
     void setLabel(const char* label);
     const char* getLabel() const   { return _label; }
-    void setShowLabel(bool show)   { _showLabel = show; _dirty = true; }
+    void setShowLabel(bool show)   { _showLabel = show; setDirty(); }
 
     // Callback
     void setOnChange(SliderChangeCallback cb) { _onChange = cb; }
@@ -366,12 +519,13 @@ public:
                uint32_t textColor = Tab5Theme::TEXT_PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UITitleBar"; m.objectBytes = sizeof(*this); }
 
     void setTitle(const char* title);
     const char* getTitle() const { return _title; }
 
-    void setBgColor(uint32_t c)   { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c) { _textColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)   { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c) { _textColor = c; setDirty(); }
 
     // Optional left/right text (e.g. back, menu)
     void setLeftText(const char* text);
@@ -411,6 +565,7 @@ public:
                 uint32_t textColor = Tab5Theme::TEXT_SECONDARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIStatusBar"; m.objectBytes = sizeof(*this); }
 
     void setText(const char* text);
     void setLeftText(const char* text);
@@ -419,8 +574,8 @@ public:
     const char* getLeftText() const  { return _leftText; }
     const char* getRightText() const { return _rightText; }
 
-    void setBgColor(uint32_t c)   { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c) { _textColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)   { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c) { _textColor = c; setDirty(); }
 
 private:
     char     _text[128];
@@ -443,16 +598,17 @@ public:
               uint32_t valueColor = Tab5Theme::TEXT_SECONDARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UITextRow"; m.objectBytes = sizeof(*this); }
 
     void setLabel(const char* label);
     void setValue(const char* value);
     const char* getLabel() const { return _label; }
     const char* getValue() const { return _value; }
 
-    void setBgColor(uint32_t c)      { _bgColor = c; _dirty = true; }
-    void setLabelColor(uint32_t c)   { _labelColor = c; _dirty = true; }
-    void setValueColor(uint32_t c)   { _valueColor = c; _dirty = true; }
-    void setShowDivider(bool show)   { _showDivider = show; _dirty = true; }
+    void setBgColor(uint32_t c)      { _bgColor = c; setDirty(); }
+    void setLabelColor(uint32_t c)   { _labelColor = c; setDirty(); }
+    void setValueColor(uint32_t c)   { _valueColor = c; setDirty(); }
+    void setShowDivider(bool show)   { _showDivider = show; setDirty(); }
 
 private:
     char     _label[128];
@@ -473,16 +629,17 @@ public:
                  uint32_t borderColor = Tab5Theme::BORDER);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIIconSquare"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
-    void setFillColor(uint32_t c)   { _fillColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c) { _borderColor = c; _dirty = true; }
-    void setCornerRadius(int16_t r) { _radius = r; _dirty = true; }
+    void setFillColor(uint32_t c)   { _fillColor = c; setDirty(); }
+    void setBorderColor(uint32_t c) { _borderColor = c; setDirty(); }
+    void setCornerRadius(int16_t r) { _radius = r; setDirty(); }
 
     // Optional single character or short text drawn centered on the icon
-    void setIconChar(const char* ch) { strncpy(_iconChar, ch, 7); _iconChar[7] = '\0'; _dirty = true; }
-    void setIconCharColor(uint32_t c) { _iconCharColor = c; _dirty = true; }
+    void setIconChar(const char* ch) { strncpy(_iconChar, ch, 7); _iconChar[7] = '\0'; setDirty(); }
+    void setIconCharColor(uint32_t c) { _iconCharColor = c; setDirty(); }
 
 private:
     uint32_t _fillColor;
@@ -503,19 +660,20 @@ public:
                  uint32_t borderColor = Tab5Theme::BORDER);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIIconCircle"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
     // For circles, hit test is circular
     bool hitTestCircle(int16_t tx, int16_t ty) const;
 
-    void setFillColor(uint32_t c)   { _fillColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c) { _borderColor = c; _dirty = true; }
-    void setRadius(int16_t r)       { _circRadius = r; _w = _h = r * 2; _dirty = true; }
+    void setFillColor(uint32_t c)   { _fillColor = c; setDirty(); }
+    void setBorderColor(uint32_t c) { _borderColor = c; setDirty(); }
+    void setRadius(int16_t r)       { _circRadius = r; _w = _h = r * 2; setDirty(); }
 
     // Optional single character drawn centered
-    void setIconChar(const char* ch) { strncpy(_iconChar, ch, 7); _iconChar[7] = '\0'; _dirty = true; }
-    void setIconCharColor(uint32_t c) { _iconCharColor = c; _dirty = true; }
+    void setIconChar(const char* ch) { strncpy(_iconChar, ch, 7); _iconChar[7] = '\0'; setDirty(); }
+    void setIconCharColor(uint32_t c) { _iconCharColor = c; setDirty(); }
 
 private:
     int16_t  _circRadius;
@@ -563,6 +721,7 @@ public:
            uint32_t hlColor    = Tab5Theme::PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIMenu"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
@@ -592,10 +751,10 @@ public:
     void setOnDismiss(TouchCallback cb) { _onDismiss = cb; }
 
     // ── Colors ──
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setHighlightColor(uint32_t c) { _hlColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setHighlightColor(uint32_t c) { _hlColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
 
 private:
     UIMenuItem _items[TAB5_MENU_MAX_ITEMS];
@@ -624,6 +783,11 @@ private:
  * The keyboard is modal: when visible it captures all touch input.
  * It is normally shown/hidden by a UITextInput, but can also be used
  * standalone via show() / hide().
+ *
+ * Each layer is rendered once into PSRAM the first time it is shown, and
+ * an all-pressed variant of it on the first key press in that layer.  Layer
+ * switches are then a single blit and key highlights blit one cell from
+ * the pressed variant.  See setLayerCache() for the memory cost.
  ******************************************************************************/
 
 // Callback fired whenever a visible character is typed or a special key
@@ -641,8 +805,10 @@ struct UIKey {
 class UIKeyboard : public UIElement {
 public:
     UIKeyboard();
+    ~UIKeyboard() override;
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override;
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
@@ -658,12 +824,19 @@ public:
     void setOnKey(KeyCallback cb)  { _onKey = cb; }
 
     // Colors
-    void setBgColor(uint32_t c)     { _bgColor = c; _dirty = true; }
-    void setKeyColor(uint32_t c)    { _keyColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)   { _textColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)     { _bgColor = c; freeLayerCache(); setDirty(); }
+    void setKeyColor(uint32_t c)    { _keyColor = c; freeLayerCache(); setDirty(); }
+    void setTextColor(uint32_t c)   { _textColor = c; freeLayerCache(); setDirty(); }
+
+    // Pre-rendered layer bitmaps (on by default unless TAB5_RENDER_MODE is 2).
+    // Each bitmap is a full keyboard, w × TAB5_KB_H × 2 bytes of PSRAM
+    // (about 0.7 MB at 1280 px).  Three layers with a normal and a pressed
+    // variant each come to about 4.4 MB once every layer has been used.
+    // false frees them and draws every key directly.
+    void setLayerCache(bool enable);
 
 private:
-    enum Layer { LOWER, UPPER, SYMBOLS };
+    enum Layer { LOWER, UPPER, SYMBOLS, LAYER_COUNT };
     Layer    _layer = LOWER;
 
     uint32_t _bgColor    = Tab5Theme::BG_DARK;
@@ -671,6 +844,11 @@ private:
     uint32_t _textColor  = Tab5Theme::TEXT_PRIMARY;
 
     KeyCallback _onKey = nullptr;
+    // Set by the focused UITextInput / UITextArea; runs before _onKey and
+    // is never deferred
+    KeyCallback _inputHook = nullptr;
+    friend class UITextInput;
+    friend class UITextArea;
 
     // Pressed key tracking
     int      _pressedRow = -1;
@@ -699,6 +877,19 @@ private:
     bool keyAt(int16_t tx, int16_t ty, int& row, int& col) const;
     // Redraw a single key directly to the display (avoids full sprite redraw)
     void drawKey(LovyanGFX& gfx, int row, int col, bool pressed);
+    // Paint the panel and every key of the current layer at (ox,oy)
+    void renderKeys(LovyanGFX& dst, int16_t ox, int16_t oy, bool allPressed);
+    // Rendered bitmap of a layer variant, built on first use unless `build`
+    // is false; nullptr if caching is off, PSRAM is short or not built yet
+    M5Canvas* layerBitmap(LovyanGFX& gfx, Layer layer, bool pressed, bool build = true);
+    void freeLayerCache();
+
+#if TAB5_RENDER_MODE != 2
+    bool      _layerCacheOn = true;
+#else
+    bool      _layerCacheOn = false;
+#endif
+    M5Canvas* _layerCache[LAYER_COUNT][2] = {};   // [layer][pressed]
 
     // Cached display pointer for single-key redraws from touch handlers
     LovyanGFX* _lastDisplay = nullptr;
@@ -732,6 +923,7 @@ public:
                 uint32_t borderColor = Tab5Theme::BORDER);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UITextInput"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
@@ -759,11 +951,11 @@ public:
     void blur();     // Close keyboard
 
     // Colors
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
     void setFocusBorderColor(uint32_t c) { _focusBorderColor = c; }
-    void setPlaceholderColor(uint32_t c) { _phColor = c; _dirty = true; }
+    void setPlaceholderColor(uint32_t c) { _phColor = c; setDirty(); }
 
 private:
     char     _text[TAB5_INPUT_MAX_LEN];
@@ -785,6 +977,99 @@ private:
     void onKeyPress(char ch);  // Internal handler for keyboard input
 };
 
+/*******************************************************************************
+ * UIContainer — Generic node that owns and clips a list of child elements
+ *
+ * Children are kept in a growable list (no fixed cap) and drawn in insertion
+ * order, clipped to the container bounds.  Each child records its parent, and
+ * marking any descendant dirty flags every container above it, so
+ * hasDirtyChild() answers in O(1) and UIManager only walks subtrees that
+ * actually need repainting.  Drawing and hit testing both skip children whose
+ * bounding box falls outside the current clip rect or touch point, so nested
+ * containers cost nothing when they are off the damaged area.
+ *
+ * Usage:
+ *   UIContainer panel(0, 48, 1280, 636);
+ *   panel.setBgColor(Tab5Theme::BG_DARK);
+ *   panel.addChild(&myButton);
+ *   panel.addChild(&myList);
+ *   ui.addElement(&panel);
+ *
+ * Child positions are absolute screen coordinates, exactly as for elements
+ * registered directly with UIManager.  Containers can be nested.
+ ******************************************************************************/
+class UIContainer : public UIElement {
+public:
+    UIContainer(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override;
+    void handleTouchDown(int16_t tx, int16_t ty) override;
+    void handleTouchMove(int16_t tx, int16_t ty) override;
+    void handleTouchUp(int16_t tx, int16_t ty) override;
+
+    // Type identification
+    bool isContainer() const override { return true; }
+
+    // ── Child management ──
+    void addChild(UIElement* child);
+    void removeChild(UIElement* child);
+    void clearChildren();
+    int  childCount() const { return (int)_children.size(); }
+    UIElement* getChild(int index) const {
+        if (index < 0 || index >= (int)_children.size()) return nullptr;
+        return _children[index];
+    }
+    /// Child receiving the current touch gesture, if any
+    UIElement* getTouchedChild() const { return _touchedChild; }
+    /// Area children are drawn in and clipped to
+    void getChildArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+        childArea(x, y, w, h);
+    }
+
+    // ── Dirty tracking ──
+    /// True if any descendant was marked dirty since the last draw pass
+    /// over this container.
+    bool hasDirtyChild() const { return _childDirty; }
+    /// Flag this container and all its ancestors as holding a dirty child.
+    void markChildDirty();
+    /// Redraw only dirty descendants (no background clear).
+    virtual void drawDirtyChildren(LovyanGFX& gfx);
+    /// Mark every visible descendant overlapping the rect dirty.  Containers
+    /// themselves are not marked, so no background clear is triggered.
+    void invalidateRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        UIElement* except = nullptr);
+    /// Repaint the container's own decoration (e.g. a tab bar) without
+    /// touching the child area.  Default: nothing.
+    virtual void drawChrome(LovyanGFX& gfx) {}
+    /// Move the container and everything in it by (dx, dy) without marking
+    /// anything dirty, e.g. to draw it into an off-screen canvas at canvas
+    /// coordinates and move it back.
+    virtual void translate(int16_t dx, int16_t dy);
+
+    // ── Hit testing ──
+    /// Deepest visible, enabled element under (tx,ty), or nullptr.
+    UIElement* findChildAt(int16_t tx, int16_t ty) const;
+    /// Deepest open overlay (menu, dropdown, popup) in the visible subtree.
+    UIElement* findOpenOverlay() const;
+
+    // ── Appearance ──
+    void setBgColor(uint32_t c) { _bgColor = c; _hasBg = true; setDirty(); }
+    void clearBgColor()         { _hasBg = false; setDirty(); }
+
+protected:
+    std::vector<UIElement*> _children;
+    UIElement* _touchedChild = nullptr;
+    bool       _childDirty   = false;
+    uint32_t   _bgColor      = Tab5Theme::BG_DARK;
+    bool       _hasBg        = false;
+
+    // Area children are clipped to (default: the container bounds)
+    virtual void childArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+    // Draw children inside the child area; dirtyOnly skips clean leaves
+    void drawChildren(LovyanGFX& gfx, bool dirtyOnly);
+};
+
 /*******************************************************************************
  * UITabView — Multi-page tabbed container
  *
@@ -805,37 +1090,59 @@ private:
  *
  * The child element positions should be relative to the content area
  * of the tab view.  The tab view translates coordinates internally.
+ *
+ * Page cache (optional):
+ *   tabs.setPageCacheBudget(8 * 1024 * 1024);   // up to 8 MB of PSRAM
+ * The last rendered bitmap of each visited page is kept in PSRAM.
+ * Switching back to a page whose layout hasn't changed is a single blit;
+ * only children dirtied in the meantime are redrawn on top.  When the
+ * budget is exceeded the least recently shown page is evicted.
+ *
+ * Transitions (optional):
+ *   tabs.setTransition(TabTransition::SLIDE, 200);   // or FADE
+ * The incoming page is rendered once off-screen, then animated by blitting
+ * both page snapshots through a strip buffer on each update().  Tapping
+ * another tab mid-animation starts a new transition from the current frame.
  ******************************************************************************/
 enum class TabPosition {
     TOP,
     BOTTOM
 };
 
+enum class TabTransition {
+    NONE,       // Instant switch (default)
+    SLIDE,      // Pages slide horizontally toward the tapped tab
+    FADE        // Crossfade between pages
+};
+
 using TabChangeCallback = std::function<void(int pageIndex)>;
 
 struct UITabPage {
-    char       label[32];
-    UIElement* children[TAB5_TAB_MAX_CHILDREN];
-    int        childCount;
+    char        label[32];
+    UIContainer content;      // Holds the page's children (no fixed cap)
+    M5Canvas*   cache      = nullptr;  // Last rendered content (page cache)
+    uint32_t    cacheStamp = 0;        // LRU stamp of the last blit/capture
+    bool        cacheStale = true;     // Screen changed since the capture
 
-    UITabPage() : childCount(0) {
+    UITabPage() : content(0, 0, 0, 0) {
         label[0] = '\0';
-        for (int i = 0; i < TAB5_TAB_MAX_CHILDREN; i++) children[i] = nullptr;
+        content.setBgColor(Tab5Theme::BG_DARK);
     }
 };
 
-class UITabView : public UIElement {
+class UITabView : public UIContainer {
 public:
     UITabView(int16_t x, int16_t y, int16_t w, int16_t h,
               TabPosition pos = TabPosition::TOP,
               uint32_t barColor    = Tab5Theme::SURFACE,
               uint32_t activeColor = Tab5Theme::PRIMARY,
               uint32_t textColor   = Tab5Theme::TEXT_PRIMARY);
+    ~UITabView() override;
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override;
+    void drawDirtyChildren(LovyanGFX& gfx) override;
     void handleTouchDown(int16_t tx, int16_t ty) override;
-    void handleTouchMove(int16_t tx, int16_t ty) override;
-    void handleTouchUp(int16_t tx, int16_t ty) override;
 
     // Type identification
     bool isTabView() const override { return true; }
@@ -865,29 +1172,48 @@ public:
     // ── Callback when the active tab changes ──
     void setOnTabChange(TabChangeCallback cb) { _onTabChange = cb; }
 
+    // ── Page cache ──
+    /// Cap on PSRAM used for cached page bitmaps.  0 (default) disables
+    /// the cache and frees any cached pages.
+    void   setPageCacheBudget(size_t bytes);
+    size_t getPageCacheBudget() const { return _cacheBudget; }
+    /// Bytes currently held by cached pages.
+    size_t getPageCacheBytes() const;
+    /// Drop one page's cached bitmap, or all of them with -1.
+    void   invalidatePageCache(int pageIndex = -1);
+
+    // ── Page transitions ──
+    /// Animate page switches.  NONE frees the transition buffers.
+    void setTransition(TabTransition t, uint16_t durationMs = 200);
+    TabTransition getTransition() const { return _transition; }
+    bool isTransitioning() const { return _transActive; }
+
     // ── Tab bar position ──
-    void setTabPosition(TabPosition pos) { _tabPos = pos; _dirty = true; }
+    void setTabPosition(TabPosition pos) { _tabPos = pos; layoutPages(); setDirty(); }
     TabPosition getTabPosition() const { return _tabPos; }
 
     // ── Colors ──
-    void setBarColor(uint32_t c)        { _barColor = c; _dirty = true; }
-    void setActiveColor(uint32_t c)     { _activeColor = c; _dirty = true; }
-    void setInactiveColor(uint32_t c)   { _inactiveColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)       { _textColor = c; _dirty = true; }
-    void setActiveTextColor(uint32_t c) { _activeTextColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)     { _borderColor = c; _dirty = true; }
-    void setTabBarHeight(int16_t h)     { _tabBarH = h; _dirty = true; }
+    void setBarColor(uint32_t c)        { _barColor = c; setDirty(); }
+    void setActiveColor(uint32_t c)     { _activeColor = c; setDirty(); }
+    void setInactiveColor(uint32_t c)   { _inactiveColor = c; setDirty(); }
+    void setTextColor(uint32_t c)       { _textColor = c; setDirty(); }
+    void setActiveTextColor(uint32_t c) { _activeTextColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)     { _borderColor = c; setDirty(); }
+    void setTabBarHeight(int16_t h)     { _tabBarH = h; layoutPages(); setDirty(); }
 
     // ── Child access ──
     int getChildCount(int pageIndex) const {
         if (pageIndex < 0 || pageIndex >= _pageCount) return 0;
-        return _pages[pageIndex].childCount;
+        return _pages[pageIndex].content.childCount();
     }
     UIElement* getChild(int pageIndex, int childIndex) const {
         if (pageIndex < 0 || pageIndex >= _pageCount) return nullptr;
-        const UITabPage& page = _pages[pageIndex];
-        if (childIndex < 0 || childIndex >= page.childCount) return nullptr;
-        return page.children[childIndex];
+        return _pages[pageIndex].content.getChild(childIndex);
+    }
+    /// The container backing a page (for nesting or direct child access).
+    UIContainer* getPage(int pageIndex) {
+        if (pageIndex < 0 || pageIndex >= _pageCount) return nullptr;
+        return &_pages[pageIndex].content;
     }
 
     // ── Content area geometry (for positioning children) ──
@@ -896,12 +1222,15 @@ public:
     int16_t contentW() const { return _w; }
     int16_t contentH() const;
 
-    // Check if any child on the active page is dirty (used by UIManager)
+    // Check if any child on the active page is dirty
     bool hasActiveDirtyChild() const;
-    // Redraw only dirty children (no background clear, no tab bar redraw)
-    void drawDirtyChildren(LovyanGFX& gfx);
     // Redraw only the tab bar (cheap, no content area clear)
     void drawTabBar(LovyanGFX& gfx);
+    void drawChrome(LovyanGFX& gfx) override { drawTabBar(gfx); }
+    void translate(int16_t dx, int16_t dy) override;
+
+protected:
+    void childArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const override;
 
 private:
     UITabPage _pages[TAB5_TAB_MAX_PAGES];
@@ -920,9 +1249,38 @@ private:
 
     TabChangeCallback _onTabChange = nullptr;
 
-    // Touch tracking for child dispatch
-    UIElement* _touchedChild = nullptr;
-
+    // Page cache
+    LovyanGFX* _lastGfx     = nullptr;   // Display of the last draw()
+    size_t     _cacheBudget = 0;
+    uint32_t   _cacheTick   = 0;
+
+    // Page transition
+    TabTransition _transition   = TabTransition::NONE;
+    uint16_t      _transMs      = 200;
+    M5Canvas*     _transOut     = nullptr;  // Outgoing page (content area)
+    M5Canvas*     _transIn      = nullptr;  // Incoming page (screen coords)
+    M5Canvas*     _transStrip   = nullptr;  // Composited rows being pushed
+    bool          _transPending = false;    // Outgoing captured, not started
+    bool          _transActive  = false;
+    int8_t        _transDir     = 1;        // +1 = incoming from the right
+    unsigned long _transStart   = 0;
+
+    // Sync page container bounds with the current content area
+    void layoutPages();
+    // Copy the on-screen content area into a page's cache
+    void capturePage(LovyanGFX& gfx, int pageIndex);
+    // Blit a page's cache if it is still valid; false if it must be drawn.
+    // (dx, dy) shifts it, for a target that isn't in screen coordinates.
+    bool blitPage(LovyanGFX& gfx, int pageIndex, int16_t dx = 0, int16_t dy = 0);
+    // Evict LRU pages (other than `keep`) until `need` more bytes fit
+    bool reservePageCache(size_t need, int keep);
+    // Transition stages: snapshot the outgoing page, render the incoming one
+    // off-screen, composite one frame, and land on the final page
+    bool captureOutgoing(LovyanGFX& gfx);
+    bool beginTransition(LovyanGFX& gfx);
+    void stepTransition(LovyanGFX& gfx);
+    void finishTransition(LovyanGFX& gfx);
+    void freeTransitionBuffers();
     // Returns true if (tx,ty) is in the tab bar area
     bool hitTestTabBar(int16_t tx, int16_t ty) const;
     // Returns the page index under (tx,ty) in the tab bar, or -1
@@ -947,6 +1305,7 @@ public:
                 const char* message = "");
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIInfoPopup"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
@@ -967,11 +1326,11 @@ public:
     void setOnDismiss(TouchCallback cb) { _onDismiss = cb; }
 
     // Colors
-    void setBgColor(uint32_t c)     { _bgColor = c; _dirty = true; }
-    void setTitleColor(uint32_t c)  { _titleColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)   { _textColor = c; _dirty = true; }
-    void setBtnColor(uint32_t c)    { _btnColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c) { _borderColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)     { _bgColor = c; setDirty(); }
+    void setTitleColor(uint32_t c)  { _titleColor = c; setDirty(); }
+    void setTextColor(uint32_t c)   { _textColor = c; setDirty(); }
+    void setBtnColor(uint32_t c)    { _btnColor = c; setDirty(); }
+    void setBorderColor(uint32_t c) { _borderColor = c; setDirty(); }
 
 private:
     char     _title[64];
@@ -1030,6 +1389,7 @@ public:
                    const char* message = "");
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIConfirmPopup"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
@@ -1054,12 +1414,12 @@ public:
     void setOnConfirm(ConfirmCallback cb) { _onConfirm = cb; }
 
     // Colors
-    void setBgColor(uint32_t c)      { _bgColor = c; _dirty = true; }
-    void setTitleColor(uint32_t c)   { _titleColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)    { _textColor = c; _dirty = true; }
-    void setYesBtnColor(uint32_t c)  { _yesBtnColor = c; _dirty = true; }
-    void setNoBtnColor(uint32_t c)   { _noBtnColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)  { _borderColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)      { _bgColor = c; setDirty(); }
+    void setTitleColor(uint32_t c)   { _titleColor = c; setDirty(); }
+    void setTextColor(uint32_t c)    { _textColor = c; setDirty(); }
+    void setYesBtnColor(uint32_t c)  { _yesBtnColor = c; setDirty(); }
+    void setNoBtnColor(uint32_t c)   { _noBtnColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)  { _borderColor = c; setDirty(); }
 
 private:
     char     _title[64];
@@ -1140,6 +1500,7 @@ public:
                  uint32_t textColor = Tab5Theme::TEXT_PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIScrollText"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -1149,19 +1510,19 @@ public:
     const char* getText() const { return _text; }
 
     // ── Appearance ──
-    void setTextSize(float s)          { _textSize = s; _needsWrap = true; _dirty = true; }
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
+    void setTextSize(float s)          { _textSize = s; _needsWrap = true; setDirty(); }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
 
     // ── Markdown colors ──
-    void setHeadingColor(uint32_t c)   { _headingColor = c; _dirty = true; }
-    void setBoldColor(uint32_t c)      { _boldColor = c; _dirty = true; }
-    void setItalicColor(uint32_t c)    { _italicColor = c; _dirty = true; }
-    void setCodeColor(uint32_t c)      { _codeColor = c; _dirty = true; }
-    void setCodeBgColor(uint32_t c)    { _codeBgColor = c; _dirty = true; }
-    void setRuleColor(uint32_t c)      { _ruleColor = c; _dirty = true; }
-    void setBulletColor(uint32_t c)    { _bulletColor = c; _dirty = true; }
+    void setHeadingColor(uint32_t c)   { _headingColor = c; setDirty(); }
+    void setBoldColor(uint32_t c)      { _boldColor = c; setDirty(); }
+    void setItalicColor(uint32_t c)    { _italicColor = c; setDirty(); }
+    void setCodeColor(uint32_t c)      { _codeColor = c; setDirty(); }
+    void setCodeBgColor(uint32_t c)    { _codeBgColor = c; setDirty(); }
+    void setRuleColor(uint32_t c)      { _ruleColor = c; setDirty(); }
+    void setBulletColor(uint32_t c)    { _bulletColor = c; setDirty(); }
 
     // ── Scroll control ──
     void scrollTo(int16_t offset);
@@ -1240,6 +1601,7 @@ public:
                       const char* content = "");
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIScrollTextPopup"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -1258,27 +1620,27 @@ public:
     void setOnDismiss(TouchCallback cb) { _onDismiss = cb; }
 
     // Color setters
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTitleColor(uint32_t c)     { _titleColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setBtnColor(uint32_t c)       { _btnColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTitleColor(uint32_t c)     { _titleColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setBtnColor(uint32_t c)       { _btnColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
 
     // Markdown colors
-    void setHeadingColor(uint32_t c)   { _headingColor = c; _dirty = true; }
-    void setBoldColor(uint32_t c)      { _boldColor = c; _dirty = true; }
-    void setItalicColor(uint32_t c)    { _italicColor = c; _dirty = true; }
-    void setCodeColor(uint32_t c)      { _codeColor = c; _dirty = true; }
-    void setCodeBgColor(uint32_t c)    { _codeBgColor = c; _dirty = true; }
-    void setRuleColor(uint32_t c)      { _ruleColor = c; _dirty = true; }
-    void setBulletColor(uint32_t c)    { _bulletColor = c; _dirty = true; }
+    void setHeadingColor(uint32_t c)   { _headingColor = c; setDirty(); }
+    void setBoldColor(uint32_t c)      { _boldColor = c; setDirty(); }
+    void setItalicColor(uint32_t c)    { _italicColor = c; setDirty(); }
+    void setCodeColor(uint32_t c)      { _codeColor = c; setDirty(); }
+    void setCodeBgColor(uint32_t c)    { _codeBgColor = c; setDirty(); }
+    void setRuleColor(uint32_t c)      { _ruleColor = c; setDirty(); }
+    void setBulletColor(uint32_t c)    { _bulletColor = c; setDirty(); }
 
     // Scroll control
     void scrollTo(int16_t offset);
     void scrollToTop()               { scrollTo(0); }
     void scrollToBottom();
 
-    void setTextSize(float s)        { _textSize = s; _needsWrap = true; _dirty = true; }
+    void setTextSize(float s)        { _textSize = s; _needsWrap = true; setDirty(); }
 
 private:
     char     _title[64];
@@ -1394,6 +1756,7 @@ public:
            uint32_t selectColor = Tab5Theme::PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIList"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -1433,12 +1796,12 @@ public:
     void scrollToItem(int index);
 
     // ── Colors ──
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setSelectColor(uint32_t c)    { _selectColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
-    void setItemHeight(int16_t h)      { _itemH = h; _autoScale = false; _dirty = true; }
-    void setTextSize(float s)          { _textSize = s; _autoScale = true; _dirty = true; }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setSelectColor(uint32_t c)    { _selectColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
+    void setItemHeight(int16_t h)      { _itemH = h; _autoScale = false; setDirty(); }
+    void setTextSize(float s)          { _textSize = s; _autoScale = true; setDirty(); }
 
 private:
     UIListItem _items[TAB5_LIST_MAX_ITEMS];
@@ -1483,11 +1846,12 @@ public:
                float textSize      = TAB5_FONT_SIZE_MD);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UICheckbox"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
     // State
-    void setChecked(bool c)    { _checked = c; _dirty = true; }
+    void setChecked(bool c)    { _checked = c; setDirty(); }
     bool isChecked() const     { return _checked; }
 
     // Label
@@ -1495,15 +1859,15 @@ public:
     const char* getLabel() const { return _label; }
 
     // Appearance
-    void setBoxColor(uint32_t c)     { _boxColor = c; _dirty = true; }
+    void setBoxColor(uint32_t c)     { _boxColor = c; setDirty(); }
     uint32_t getBoxColor() const     { return _boxColor; }
-    void setCheckColor(uint32_t c)   { _checkColor = c; _dirty = true; }
+    void setCheckColor(uint32_t c)   { _checkColor = c; setDirty(); }
     uint32_t getCheckColor() const   { return _checkColor; }
-    void setTextColor(uint32_t c)    { _textColor = c; _dirty = true; }
+    void setTextColor(uint32_t c)    { _textColor = c; setDirty(); }
     uint32_t getTextColor() const    { return _textColor; }
-    void setTextSize(float s)        { _textSize = s; _dirty = true; }
+    void setTextSize(float s)        { _textSize = s; setDirty(); }
     float getTextSize() const        { return _textSize; }
-    void setBorderColor(uint32_t c)  { _borderColor = c; _dirty = true; }
+    void setBorderColor(uint32_t c)  { _borderColor = c; setDirty(); }
 
 private:
     char     _label[64];
@@ -1551,11 +1915,12 @@ public:
                   float textSize       = TAB5_FONT_SIZE_MD);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIRadioButton"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
 
     // State
-    void setSelected(bool s)    { _selected = s; _dirty = true; }
+    void setSelected(bool s)    { _selected = s; setDirty(); }
     bool isSelected() const     { return _selected; }
 
     // Group
@@ -1567,15 +1932,15 @@ public:
     const char* getLabel() const { return _label; }
 
     // Appearance
-    void setCircleColor(uint32_t c)    { _circleColor = c; _dirty = true; }
+    void setCircleColor(uint32_t c)    { _circleColor = c; setDirty(); }
     uint32_t getCircleColor() const    { return _circleColor; }
-    void setDotColor(uint32_t c)       { _dotColor = c; _dirty = true; }
+    void setDotColor(uint32_t c)       { _dotColor = c; setDirty(); }
     uint32_t getDotColor() const       { return _dotColor; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
     uint32_t getTextColor() const      { return _textColor; }
-    void setTextSize(float s)          { _textSize = s; _dirty = true; }
+    void setTextSize(float s)          { _textSize = s; setDirty(); }
     float getTextSize() const          { return _textSize; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
 
 private:
     char     _label[64];
@@ -1610,6 +1975,7 @@ public:
                uint32_t selectColor = Tab5Theme::PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIDropdown"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -1654,12 +2020,12 @@ public:
 
     // ── Appearance ──
     void setPlaceholder(const char* text);
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setSelectColor(uint32_t c)    { _selectColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
-    void setTextSize(float s)          { _textSize = s; _dirty = true; }
-    void setMaxVisibleItems(int n)     { _maxVisible = n; _dirty = true; }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setSelectColor(uint32_t c)    { _selectColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
+    void setTextSize(float s)          { _textSize = s; setDirty(); }
+    void setMaxVisibleItems(int n)     { _maxVisible = n; setDirty(); }
 
     /// Constrain the dropdown list to stay within the given vertical bounds.
     /// Typically set to the TabView's content area so the list doesn't
@@ -1789,6 +2155,7 @@ public:
                  uint32_t selectColor = Tab5Theme::PRIMARY);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UIColumnList"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -1801,10 +2168,10 @@ public:
     void setColumnAlign(int col, textdatum_t align);
     void setColumnSortable(int col, bool sortable);
     int  columnCount() const { return _colCount; }
-    void setShowHeader(bool show) { _showHeader = show; _dirty = true; }
+    void setShowHeader(bool show) { _showHeader = show; setDirty(); }
 
     // ── Sorting ──
-    void setSortable(bool s)  { _sortEnabled = s; _dirty = true; }
+    void setSortable(bool s)  { _sortEnabled = s; setDirty(); }
     bool isSortable() const   { return _sortEnabled; }
     void sortByColumn(int col, SortDir dir = SortDir::ASC);
     void clearSort();                 // Remove sort, restore insertion order
@@ -1840,18 +2207,18 @@ public:
     void scrollToRow(int index);
 
     // ── Appearance ──
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setSelectColor(uint32_t c)    { _selectColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
-    void setHeaderBgColor(uint32_t c)  { _headerBgColor = c; _dirty = true; }
-    void setHeaderTextColor(uint32_t c){ _headerTextColor = c; _dirty = true; }
-    void setItemHeight(int16_t h)      { _itemH = h; _autoScale = false; _dirty = true; }
-    void setTextSize(float s)          { _textSize = s; _autoScale = true; _dirty = true; }
-    void setHeaderTextSize(float s)    { _headerTextSize = s; _dirty = true; }
-    void setDividerColor(uint32_t c)   { _dividerColor = c; _dirty = true; }
-    void setShowColumnDividers(bool s) { _showColDividers = s; _dirty = true; }
-    void setSortIndicatorColor(uint32_t c) { _sortIndicatorColor = c; _dirty = true; }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setSelectColor(uint32_t c)    { _selectColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
+    void setHeaderBgColor(uint32_t c)  { _headerBgColor = c; setDirty(); }
+    void setHeaderTextColor(uint32_t c){ _headerTextColor = c; setDirty(); }
+    void setItemHeight(int16_t h)      { _itemH = h; _autoScale = false; setDirty(); }
+    void setTextSize(float s)          { _textSize = s; _autoScale = true; setDirty(); }
+    void setHeaderTextSize(float s)    { _headerTextSize = s; setDirty(); }
+    void setDividerColor(uint32_t c)   { _dividerColor = c; setDirty(); }
+    void setShowColumnDividers(bool s) { _showColDividers = s; setDirty(); }
+    void setSortIndicatorColor(uint32_t c) { _sortIndicatorColor = c; setDirty(); }
 
 private:
     // Columns
@@ -1947,6 +2314,7 @@ public:
                uint32_t borderColor = Tab5Theme::BORDER);
 
     void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override { m.type = "UITextArea"; m.objectBytes = sizeof(*this); }
     void handleTouchDown(int16_t tx, int16_t ty) override;
     void handleTouchMove(int16_t tx, int16_t ty) override;
     void handleTouchUp(int16_t tx, int16_t ty) override;
@@ -1982,12 +2350,12 @@ public:
     void scrollToCursor();
 
     // ── Appearance ──
-    void setTextSize(float s)          { _textSize = s; _needsWrap = true; _dirty = true; }
-    void setBgColor(uint32_t c)        { _bgColor = c; _dirty = true; }
-    void setTextColor(uint32_t c)      { _textColor = c; _dirty = true; }
-    void setBorderColor(uint32_t c)    { _borderColor = c; _dirty = true; }
+    void setTextSize(float s)          { _textSize = s; _needsWrap = true; setDirty(); }
+    void setBgColor(uint32_t c)        { _bgColor = c; setDirty(); }
+    void setTextColor(uint32_t c)      { _textColor = c; setDirty(); }
+    void setBorderColor(uint32_t c)    { _borderColor = c; setDirty(); }
     void setFocusBorderColor(uint32_t c) { _focusBorderColor = c; }
-    void setPlaceholderColor(uint32_t c) { _phColor = c; _dirty = true; }
+    void setPlaceholderColor(uint32_t c) { _phColor = c; setDirty(); }
 
 private:
     char     _text[TAB5_TEXTAREA_MAX_LEN];
@@ -2039,6 +2407,506 @@ private:
     void     ensureCursorVisible();
 };
 
+/*******************************************************************************
+ * UIChart — Real-time scrolling line chart
+ *
+ * Plots one or more series, each a fixed-capacity ring buffer of samples
+ * with O(1) push().  One sample per pixel column, newest at the right edge.
+ * When only new samples arrived since the last draw, the plot already on
+ * the panel is scrolled left in place and only the new columns are drawn,
+ * so the cost of a frame follows the number of new samples, not the plot
+ * width.  The Y range autoscales with some headroom (only rescaling, and
+ * so redrawing in full, when data leaves it or shrinks well inside it), or
+ * can be fixed with setRange().
+ *
+ * Every series advances together: the plot scrolls by the number of
+ * samples *all* series have received, so push each series once per sample
+ * period.
+ *
+ * Each series also keeps a min/max pyramid (levels of 8, 64, 512, …
+ * samples per bucket) that is updated on every push.  setView() zooms out
+ * to any number of samples across the plot and pans back through history;
+ * each pixel column is then one min–max span read from the pyramid, so a
+ * redraw costs O(plot width) whether the view holds a thousand samples or
+ * a million.  ChartMode::LINE draws a single LTTB-downsampled trace
+ * instead (O(samples in view)).
+ *
+ * Usage:
+ *   UIChart chart(20, 80, 1000, 300);
+ *   int temp = chart.addSeries(Tab5Theme::ACCENT);
+ *   int hum  = chart.addSeries(Tab5Theme::PRIMARY);
+ *   ui.addElement(&chart);
+ *   ...
+ *   chart.push(readTemp(), temp);     // O(1); drawn by the next update()
+ *   chart.push(readHumidity(), hum);
+ ******************************************************************************/
+
+#define TAB5_CHART_MAX_SERIES  4
+#define TAB5_CHART_MAX_LEVELS  8      // Min/max pyramid levels per series
+
+// How a zoomed-out view draws more samples than there are pixel columns
+enum class ChartMode : uint8_t {
+    ENVELOPE,     // Min–max span per column: every peak stays visible
+    LINE          // One trace through LTTB-selected samples
+};
+
+struct UIChartBucket {
+    float lo, hi;                     // +inf / -inf when the bucket is all NaN
+};
+
+struct UIChartSeries {
+    float*   data     = nullptr;      // Ring buffer (PSRAM when available)
+    uint32_t capacity = 0;            // Multiple of the top pyramid bucket
+    uint32_t head     = 0;            // Next write slot
+    uint32_t count    = 0;            // Samples held (≤ capacity)
+    uint32_t pending  = 0;            // Pushed but not yet on screen
+    uint64_t total    = 0;            // Samples ever pushed
+    uint32_t color    = Tab5Theme::PRIMARY;
+    // levels[l] holds capacity >> 3(l+1) buckets of 8^(l+1) samples each,
+    // indexed by absolute sample number, so the ring never needs rebuilding
+    UIChartBucket* levels[TAB5_CHART_MAX_LEVELS] = {};
+    uint8_t  levelCount = 0;
+};
+
+class UIChart : public UIElement {
+public:
+    UIChart(int16_t x, int16_t y, int16_t w, int16_t h,
+            uint32_t bgColor   = Tab5Theme::BG_MEDIUM,
+            uint32_t gridColor = Tab5Theme::DIVIDER);
+    ~UIChart() override;
+
+    void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override;
+
+    // ── Series ──
+    /// Add a series keeping `capacity` samples (at least the plot width).
+    /// Returns its index, or -1 if TAB5_CHART_MAX_SERIES is reached or the
+    /// buffer can't be allocated.
+    int   addSeries(uint32_t color, uint32_t capacity = 0);
+    int   seriesCount() const { return _seriesCount; }
+    void  setSeriesColor(int series, uint32_t color);
+    /// Append a sample (NaN leaves a gap).  O(1); the oldest sample
+    /// drops off when the buffer is full.
+    void  push(float value, int series = 0);
+    /// Append n samples at once, e.g. a loaded capture.
+    void  pushBlock(const float* values, uint32_t n, int series = 0);
+    /// Sample `age` steps back from the newest (0 = newest).
+    float sample(int series, uint32_t age) const;
+    uint32_t sampleCount(int series) const;
+    void  clear();                    // Drop every sample
+
+    // ── Y range ──
+    void  setRange(float lo, float hi);   // Fixed range (turns autoscale off)
+    void  setAutoScale(bool on = true);
+    float getRangeMin() const { return _lo; }
+    float getRangeMax() const { return _hi; }
+
+    // ── Zoom & pan ──
+    /// Show `span` samples across the plot, ending `offset` samples before
+    /// the newest.  offset 0 follows new data; otherwise the view stays on
+    /// the same samples as more arrive.
+    void  setView(uint32_t span, uint32_t offset = 0);
+    void  setLive();                  // Back to one sample per column, scrolling
+    bool  isLive() const { return _viewSpan == 0; }
+    uint32_t getViewSpan() const;
+    uint32_t getViewOffset() const;
+    void  setDrawMode(ChartMode m);   // For views wider than the plot
+    ChartMode getDrawMode() const { return _mode; }
+
+    // ── Appearance ──
+    /// Horizontal grid rows, and a vertical line every `columnEvery`
+    /// samples that scrolls with the data (0 = none).  Zoomed-out views
+    /// scale the spacing so lines stay about as far apart.
+    void  setGrid(uint8_t rows, uint16_t columnEvery);
+    void  setShowScale(bool show);    // Min / mid / max labels on the left
+    void  setBgColor(uint32_t c)   { _bgColor = c; invalidate(); }
+    void  setGridColor(uint32_t c) { _gridColor = c; invalidate(); }
+
+private:
+    UIChartSeries _series[TAB5_CHART_MAX_SERIES];
+    int      _seriesCount = 0;
+    uint32_t _bgColor;
+    uint32_t _gridColor;
+    uint8_t  _gridRows    = 4;
+    uint16_t _gridEvery   = 50;
+    bool     _showScale   = true;
+
+    // Plot area, relative to the widget
+    int16_t  _plotX = 0, _plotY = 0, _plotW = 0, _plotH = 0;
+
+    // Y range and the extremes of the samples on screen
+    bool     _autoScale   = true;
+    float    _lo = 0.0f, _hi = 1.0f;
+    float    _dataMin = 0.0f, _dataMax = 0.0f;
+    bool     _haveData    = false;
+    bool     _extentsStale = false;    // An extreme scrolled off
+
+    uint32_t _columns     = 0;          // Samples scrolled in so far
+    const LovyanGFX* _lastTarget = nullptr;
+
+    // Zoomed / panned view (span 0 = live)
+    uint32_t _viewSpan    = 0;
+    uint64_t _viewEnd     = 0;          // Series 0 sample after the view
+    bool     _viewFollow  = true;
+    ChartMode _mode       = ChartMode::ENVELOPE;
+
+    void     layout();
+    void     append(UIChartSeries& s, float v);
+    bool     spanMinMax(const UIChartSeries& s, int64_t a, int64_t b,
+                        float& lo, float& hi) const;
+    float    sampleAt(const UIChartSeries& s, int64_t i) const;
+    int64_t  viewEnd(const UIChartSeries& s) const;
+    void     drawView(LovyanGFX& dst, int16_t ox, int16_t oy);
+    void     drawLTTB(LovyanGFX& dst, const UIChartSeries& s, int16_t x0,
+                      int16_t oy, int64_t start, uint32_t color);
+    uint32_t readyColumns() const;
+    bool     advance(uint32_t k);       // Take k pending samples on screen
+    void     rescanExtents();
+    bool     updateRange();             // true if the range changed
+    int16_t  valueToY(float v) const;
+    void     drawFrame(LovyanGFX& dst, int16_t ox, int16_t oy);
+    void     drawColumns(LovyanGFX& dst, int16_t ox, int16_t oy, int16_t c0, int16_t c1);
+};
+
+/*******************************************************************************
+ * UIWaterfall — Scrolling spectrogram / waterfall display
+ *
+ * Takes one row of magnitudes at a time (e.g. an FFT frame), maps it
+ * through a 256-entry colour LUT straight into RGB565, and stores it as one
+ * line of a ring-buffered image in PSRAM: a new line overwrites the oldest
+ * and moves the ring offset, so nothing is memmoved.  On the next draw the
+ * image already on the panel is scrolled by the number of new lines with
+ * copyRect() and only those lines are pushed.
+ *
+ * WaterfallFlow::DOWN puts the newest line at the top (bins left → right);
+ * WaterfallFlow::LEFT puts it at the right edge (bins bottom → top).  The
+ * icons/icon_waterfalls_v.h and icon_waterfalls_h.h icons fit a toggle.
+ *
+ * Usage:
+ *   UIWaterfall wf(20, 80, 1024, 400);
+ *   wf.setRange(-90.0f, -20.0f);        // dB mapped to the colour map
+ *   ui.addElement(&wf);
+ *   ...
+ *   wf.pushRow(spectrumDb, 512);        // Bins resampled to the width
+ ******************************************************************************/
+
+enum class WaterfallFlow : uint8_t {
+    DOWN,         // Newest row at the top, scrolling down
+    LEFT          // Newest column at the right, scrolling left
+};
+
+class UIWaterfall : public UIElement {
+public:
+    UIWaterfall(int16_t x, int16_t y, int16_t w, int16_t h,
+                WaterfallFlow flow = WaterfallFlow::DOWN);
+    ~UIWaterfall() override;
+
+    void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override;
+
+    /// Append one line.  `bins` values are spread over the line's pixels;
+    /// when there are more bins than pixels each pixel shows the largest.
+    void pushRow(const float* mags, uint16_t bins);
+    /// Same, with magnitudes already scaled to colour map indices.
+    void pushRow(const uint8_t* levels, uint16_t bins);
+    void clear();                     // Fill with colour map entry 0
+    uint32_t getRowCount() const { return _rows; }
+
+    /// Magnitudes mapped onto the colour map (default 0 … 1); values
+    /// outside are clamped.
+    void  setRange(float lo, float hi);
+    float getRangeMin() const { return _lo; }
+    float getRangeMax() const { return _hi; }
+    /// Build the colour map from `count` RGB888 stops spaced evenly over
+    /// 0 … 255.  Applies to lines pushed from now on.
+    void  setColorMap(const uint32_t* stops, uint8_t count);
+    void  setFlow(WaterfallFlow flow);   // Clears the image
+    WaterfallFlow getFlow() const { return _flow; }
+
+private:
+    WaterfallFlow _flow;
+    uint16_t  _lut[256];              // Byte-swapped RGB565, as sprites hold it
+    float     _lo = 0.0f, _hi = 1.0f;
+    float     _scale = 255.0f;         // LUT steps per unit
+
+    // Ring image: _lines lines of _lineLen pixels, newest at slot _newest,
+    // each older line at the next slot up
+    uint16_t* _image   = nullptr;
+    int16_t   _lines   = 0;
+    int16_t   _lineLen = 0;
+    int16_t   _newest  = 0;
+    int16_t   _pending = 0;            // Lines pushed since the last draw
+    uint32_t  _rows    = 0;
+    const LovyanGFX* _lastTarget = nullptr;
+
+    bool      ensureImage();
+    uint16_t* nextLine();
+    void      pushLines(LovyanGFX& gfx, int16_t first, int16_t n);
+    void      pushAll(LovyanGFX& gfx);
+};
+
+/*******************************************************************************
+ * UIGauge — Analog dial with a needle
+ *
+ * The dial face (arc, colour zones, ticks, labels, title) is rendered once
+ * into a cached PSRAM sprite and only rebuilt when its appearance or size
+ * changes.  A value update recomposes just the union of the old and new
+ * needle bounding boxes (plus the readout, if shown) from that cache in the
+ * shared sprite and pushes it, so moving the needle costs a small blit
+ * instead of redrawing arcs and ticks.
+ *
+ * The dial spans 270°, from the lower left (min) clockwise to the lower
+ * right (max), and fits the smaller of w and h.
+ *
+ * Usage:
+ *   UIGauge rpm(20, 80, 300, 300, 0, 8000);
+ *   rpm.setTitle("RPM");
+ *   rpm.setTicks(8, 5);
+ *   rpm.addZone(6500, 8000, Tab5Theme::DANGER);
+ *   ui.addElement(&rpm);
+ *   ...
+ *   rpm.setValue(engineRpm());
+ ******************************************************************************/
+
+#define TAB5_GAUGE_MAX_ZONES  4
+
+class UIGauge : public UIElement {
+public:
+    UIGauge(int16_t x, int16_t y, int16_t w, int16_t h,
+            float minVal = 0.0f, float maxVal = 100.0f,
+            uint32_t needleColor = Tab5Theme::ACCENT,
+            uint32_t bgColor     = Tab5Theme::BG_MEDIUM);
+    ~UIGauge() override;
+
+    void draw(LovyanGFX& gfx) override;
+    void memoryInfo(UIMemoryInfo& m) const override;
+
+    // ── Value ──
+    void  setValue(float v);          // Clamped to the range
+    float getValue() const { return _value; }
+    void  setRange(float minVal, float maxVal);
+    float getMin() const { return _min; }
+    float getMax() const { return _max; }
+
+    // ── Dial face (changing these rebuilds the cached face) ──
+    /// `major` labelled divisions, each split into `minor` steps.
+    void  setTicks(uint8_t major, uint8_t minor);
+    void  setTitle(const char* title);    // Under the hub, e.g. a unit
+    /// Colour the arc from `from` to `to`.  false if TAB5_GAUGE_MAX_ZONES
+    /// zones are already set.
+    bool  addZone(float from, float to, uint32_t color);
+    void  clearZones();
+    void  setArcColor(uint32_t c);
+    void  setBgColor(uint32_t c);
+
+    // ── Needle & readout ──
+    void  setNeedleColor(uint32_t c)  { _needleColor = c; setDirty(); }
+    void  setShowValue(bool show);    // Numeric readout under the hub
+    void  setDecimals(uint8_t d)      { _decimals = d; setDirty(); }
+
+private:
+    struct Zone { float from, to; uint32_t color; };
+    struct Box  { int16_t x0, y0, x1, y1; };   // Widget-relative, exclusive end
+
+    float    _value;
+    float    _min, _max;
+    uint32_t _needleColor;
+    uint32_t _bgColor;
+    uint32_t _arcColor    = Tab5Theme::BORDER;
+    uint8_t  _major       = 10;
+    uint8_t  _minor       = 5;
+    uint8_t  _decimals    = 0;
+    bool     _showValue   = true;
+    char     _title[24]   = "";
+    Zone     _zones[TAB5_GAUGE_MAX_ZONES];
+    uint8_t  _zoneCount   = 0;
+
+    M5Canvas* _face       = nullptr;   // Cached dial face, PSRAM
+    bool     _faceStale   = true;
+    Box      _lastBox     = {0, 0, 0, 0};   // Needle + readout last drawn
+    const LovyanGFX* _lastTarget = nullptr;
+
+    // Dial geometry, relative to the widget
+    int16_t  _cx = 0, _cy = 0, _r = 0;
+    int16_t  _readoutH = 0;
+
+    void     layout();
+    float    angleOf(float v) const;       // Degrees, clockwise from 3 o'clock
+    bool     buildFace(LovyanGFX& gfx);    // true if the face was (re)rendered
+    void     drawFace(LovyanGFX& dst, int16_t ox, int16_t oy);
+    Box      dynamicBox() const;
+    void     drawDynamic(LovyanGFX& dst, int16_t ox, int16_t oy);
+    void     faceDirty()   { _faceStale = true; invalidate(); }
+};
+
+/*******************************************************************************
+ * Render statistics — snapshot returned by UIManager::getStats()
+ *
+ * Every value is summarised over the last TAB5_STATS_WINDOW frames.  A frame
+ * is an update() pass that dispatched touch or drew something; idle passes
+ * are not sampled.  Times are in microseconds.  Per-tag draw times include
+ * the children of containers.
+ *
+ * Usage:
+ *   ui.setStatsEnabled(true);            // or ui.setStatsHud(true)
+ *   UIStats st = ui.getStats();
+ *   Serial.printf("frame p99 %lu us\n", (unsigned long)st.frameUs.p99);
+ ******************************************************************************/
+struct UIStat {
+    uint32_t min = 0;
+    uint32_t avg = 0;
+    uint32_t p99 = 0;
+};
+
+struct UITagStat {
+    char     tag[16];       // Element tag ("-" for untagged elements)
+    UIStat   drawUs;        // Time in draw() per call
+};
+
+struct UIStats {
+    uint32_t  frames        = 0;  // Frames sampled since reset
+    UIStat    frameUs;            // Whole update() pass
+    UIStat    drawUs;             // drawDirty() pass
+    UIStat    touchUs;            // Touch read → handler returned
+    UIStat    pixels;             // Pixels pushed per frame
+    UIStat    bytes;              // Bytes pushed per frame (RGB565)
+    UIStat    dirty;              // Elements drawn per frame
+    uint32_t  spriteAllocs  = 0;  // Shared sprite buffer growths since reset
+    int       tagCount      = 0;
+    UITagStat tags[TAB5_STATS_MAX_TAGS];
+};
+
+/*******************************************************************************
+ * Touch session log — recorded by UIManager::startTouchRecording()
+ *
+ * A compact binary log of the raw touch stream: one UITouchLogHeader
+ * followed by one 8-byte UITouchEvent per change (press, move, release) as
+ * seen by update().  Fields are little-endian.  The bytes can be written out
+ * as-is (Serial.write, SD card) and handed back to replayTouchLog() later,
+ * on this or another device.
+ *
+ * Usage:
+ *   ui.startTouchRecording();
+ *   ...                                   // user reproduces the problem
+ *   ui.stopTouchRecording();
+ *   size_t n;
+ *   const uint8_t* log = ui.getTouchLog(n);
+ *   Serial.write(log, n);
+ *
+ *   UIReplayReport r = ui.replayTouchLog(log, n);
+ *   Serial.printf("%lu/%lu frames dropped\n", r.dropped, r.frames);
+ ******************************************************************************/
+struct UITouchLogHeader {
+    char     magic[4];      // "T5TL"
+    uint16_t version;       // 1
+    uint16_t eventSize;     // sizeof(UITouchEvent)
+    uint32_t count;         // Events that follow
+};
+
+struct UITouchEvent {
+    uint32_t ms;            // Time since recording started
+    int16_t  x;             // Touch position; -1, -1 on release
+    int16_t  y;
+};
+
+// Result of UIManager::replayTouchLog().  Times are in microseconds and
+// summarised over the whole replay.
+struct UIReplayReport {
+    bool     ok          = false;  // Log was valid and replayed
+    uint32_t events      = 0;      // Touch events replayed
+    uint32_t frames      = 0;      // update() passes run
+    uint32_t dropped     = 0;      // Passes that overran the frame period
+    uint32_t worstFrame  = 0;      // Index of the slowest pass
+    UIStat   frameUs;              // Whole update() pass
+    UIStat   dispatchUs;           // Touch handlers incl. user callbacks,
+                                   // over passes that dispatched
+};
+
+/*******************************************************************************
+ * Overdraw summary — returned by UIManager::getOverdrawStats()
+ *
+ * Counts are paints per TAB5_OVERDRAW_CELL-square cell in one update()
+ * pass: each element draw at any depth, keyboard key repaints, modal
+ * erases and standalone sprite pushes.  1 is ideal; a container that
+ * clears its area before its children paint over it shows up as 2+.
+ ******************************************************************************/
+struct UIOverdrawStats {
+    uint32_t frames    = 0;     // Passes that painted anything, since reset
+    uint8_t  cellSize  = 0;     // Pixels per cell side
+    uint16_t cellsX    = 0;     // Heatmap size in cells
+    uint16_t cellsY    = 0;
+    uint32_t lastCells = 0;     // Cells painted in the last pass
+    float    lastAvg   = 0;     // Mean paints per painted cell, last pass
+    uint8_t  peakMax   = 0;     // Highest count in any cell, since reset
+    uint32_t hotCells  = 0;     // Cells that reached 3+ in a pass, since reset
+};
+
+// Heap activity inside UIManager::update(), returned by getAllocStats().
+// An idle or scrolling UI should stay at allocFrames == 0.
+struct UIAllocStats {
+    bool     tracking    = false;  // TAB5_ALLOC_TRACK on, heap hooks present
+    uint32_t frames      = 0;      // update() passes since reset
+    uint32_t allocFrames = 0;      // ...of which allocated anything
+    uint32_t allocs      = 0;      // Allocations in those passes
+    uint32_t frees       = 0;      // Frees in those passes
+    uint32_t bytes       = 0;      // Bytes requested in those passes
+    uint32_t maxAllocs   = 0;      // Most allocations in one pass
+    uint32_t lastAllocs  = 0;      // Allocations in the latest pass
+};
+
+/*******************************************************************************
+ * Touch-to-photon latency — per widget type, from UIManager::getLatencyStats()
+ *
+ * Each sample runs from the moment update() read the touch panel to the
+ * end of the last panel write that followed in the same pass (sprite
+ * push or direct draw), for presses, drags and releases the widget
+ * handled.  Panel scan-out adds up to one refresh period on top.
+ * Bucket i counts samples below TAB5_LATENCY_BOUNDS_MS[i] (the last
+ * bucket is everything slower).
+ ******************************************************************************/
+#define TAB5_LATENCY_BUCKETS   8
+#define TAB5_LATENCY_MAX_TYPES 16
+constexpr uint16_t TAB5_LATENCY_BOUNDS_MS[TAB5_LATENCY_BUCKETS] = {
+    4, 8, 16, 33, 50, 100, 200, 0xFFFF
+};
+
+struct UILatencyHist {
+    const char* type     = nullptr;   // Widget type ("UIButton", ...)
+    uint32_t    count    = 0;
+    uint32_t    buckets[TAB5_LATENCY_BUCKETS] = {};
+    uint32_t    maxUs    = 0;
+    uint64_t    totalUs  = 0;         // For the mean
+};
+
+/*******************************************************************************
+ * Callback overruns — from UIManager::getCallbackOverruns()
+ *
+ * One entry per element tag and callback ("onTouch", "onSelect", ...)
+ * that ran longer than the callback budget.  Elements without a tag are
+ * reported by widget type.
+ ******************************************************************************/
+struct UICallbackOverrun {
+    const char* tag     = nullptr;
+    const char* name    = nullptr;   // Callback, e.g. "onChange"
+    uint32_t    count   = 0;         // Times over budget
+    uint32_t    lastUs  = 0;
+    uint32_t    worstUs = 0;
+};
+
+enum class HudCorner {
+    TOP_LEFT,
+    TOP_RIGHT,
+    BOTTOM_LEFT,
+    BOTTOM_RIGHT
+};
+
+// String argument of a posted setter, copied so the sender's buffer can go
+struct UIPostString {
+    char s[TAB5_POST_STR_MAX];
+    UIPostString(const char* v);   // nullptr → ""
+    operator const char*() const { return s; }
+};
+
 /******************************************************************************* * UIManager — Manages all UI elements, handles drawing and touch dispatch
  *****************************************************************************/
 class UIManager {
@@ -2059,6 +2927,33 @@ public:
     // ── Touch Processing ── call this in loop()
     void update();
 
+    // ── Cross-task updates ──
+    /// Queue `(target->*setter)(args...)` from any task or core; update()
+    /// applies queued calls in order at the start of its next frame, on
+    /// the UI task.  Lock-free and allocation-free.  Returns false (and
+    /// counts a drop) if the queue is full.  e.g.
+    ///   ui.post(&tempLabel, &UILabel::setText, "23.4 C");
+    ///   ui.post(&volume, &UISlider::setValue, 42);
+    /// An overloaded setter (UIColumnList::setCellText) needs a cast to
+    /// pick one: static_cast<void (UIColumnList::*)(int, int, const char*)>.
+    template <typename W, typename C, typename R, typename... P, typename... A>
+    bool post(W* target, R (C::*setter)(P...), A&&... args);
+    /// Queue a plain function call, e.g. for several related changes.
+    bool post(void (*fn)(void* arg), void* arg);
+    /// Calls rejected because the queue was full.
+    uint32_t getPostDropped() const;
+
+    // ── Batched updates ──
+    /// Hold back all drawing (update() still handles touch) while a group
+    /// of setters runs, so no pass shows a half-updated screen.  Calls
+    /// nest; after the outermost endUpdate() the next update() draws
+    /// everything that changed in one pass, ignoring the frame budget.
+    /// Safe to call from any task: endUpdate() never draws itself.
+    /// See also UIUpdateGuard.
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const { return _batchDepth.load() > 0; }
+
     // ── Accessors ──
     M5GFX& getDisplay() { return _gfx; }
     UIElement* findByTag(const char* tag);
@@ -2084,10 +2979,130 @@ public:
     void setOnSleep(SleepCallback cb) { _onSleep = cb; }
     void setOnWake(SleepCallback cb)  { _onWake = cb; }
 
+    // ── Touch & clock sources ──
+    // Replace the touch panel and millis() with your own, e.g. to drive the
+    // UI from a test, a recorded session or a headless build.  The clock is
+    // used library-wide (debounce, sleep timeout, animations).  Pass
+    // nullptr to restore the defaults.
+    /// Return true and fill (x,y) while a finger is down.
+    using TouchSource = std::function<bool(int16_t& x, int16_t& y)>;
+    using ClockSource = std::function<unsigned long()>;
+    void setTouchSource(TouchSource src) { _touchSource = src; }
+    void setClock(ClockSource clock);
+
+    // ── Redraw-region overlay ──
+    /// Debug aid: after each pass, outline every rectangle written to the
+    /// panel (green = once, yellow = twice, red = 3+ times in that pass)
+    /// with a running count of how often that region has been repainted.
+    void setRedrawOverlay(bool show);
+    bool isRedrawOverlay() const;
+
+    // ── Allocation tracking ── (see UIAllocStats; zeros unless
+    //    TAB5_ALLOC_TRACK is 1 and the heap hooks are available)
+    UIAllocStats getAllocStats() const;
+    void         resetAllocStats();
+
+    // ── Overdraw tracking ── (see UIOverdrawStats above)
+    /// Allocates the heatmap on first enable; false if out of memory.
+    bool setOverdrawTracking(bool enable);
+    bool isOverdrawTracking() const;
+    UIOverdrawStats getOverdrawStats() const;
+    void resetOverdraw();
+    /// Peak paints per cell since reset as a plain-text PPM image (one
+    /// pixel per cell; save the output as .ppm).
+    void dumpOverdrawHeatmap(Print& out) const;
+
+    // ── Touch-to-photon latency ── (see UILatencyHist above)
+    void setLatencyTracking(bool enable);
+    bool isLatencyTracking() const;
+    /// Copies up to `max` per-type histograms; returns how many there are.
+    int  getLatencyStats(UILatencyHist* out, int max) const;
+    void resetLatency();
+    /// Print each type's histogram, mean and worst case.
+    void latencyReport(Print& out) const;
+
+    // ── Redraw scheduling ──
+    /// Time budget (µs) for one drawDirty() pass; 0 (default) = unlimited.
+    /// Dirty widgets are drawn by priority (touched widget, overlays,
+    /// content, then BACKGROUND ones); once the budget is spent, the rest
+    /// stay dirty and are drawn by the next update().  The touched widget
+    /// and overlays are never held back.  With a budget, drawAll() paints
+    /// progressively the same way.
+    void     setFrameBudget(uint32_t us) { _frameBudgetUs = us; }
+    uint32_t getFrameBudget() const      { return _frameBudgetUs; }
+    /// Draws the budget pushed to a later pass in the last drawDirty().
+    int      getCarriedRedraws() const;
+    /// True while any visible element still waits to be drawn.
+    bool     isRedrawPending() const;
+
+    // ── Callback deferral & watchdog ── (see UICallbackOverrun above)
+    /// Run widget callbacks fired by touch handling after update() has
+    /// drawn the pass's feedback (pressed states, ripples), then redraw
+    /// whatever they changed.  Off by default: callbacks run inline.
+    /// String arguments point into widget storage — copy them before
+    /// changing the widget that passed them.
+    void setDeferredCallbacks(bool defer);
+    bool isDeferredCallbacks() const;
+    /// Report callbacks running longer than `us` (0 turns the watchdog off).
+    void     setCallbackBudget(uint32_t us);
+    uint32_t getCallbackBudget() const;
+    /// Called right after an over-budget callback returns.
+    using CallbackOverrunHandler =
+        std::function<void(const char* tag, const char* name, uint32_t us)>;
+    void setOnCallbackOverrun(CallbackOverrunHandler handler);
+    /// Copies up to `max` entries; returns how many there are.
+    int  getCallbackOverruns(UICallbackOverrun* out, int max) const;
+    void resetCallbackOverruns();
+    /// Print every over-budget callback with its count and worst time.
+    void callbackReport(Print& out) const;
+
+    // ── Memory report ──
+    /// Print object sizes and owned buffers of every registered element
+    /// (containers included recursively), totals per widget type, and the
+    /// library's shared buffers.
+    void memoryReport(Print& out) const;
+
+    // ── Event tracing ── (no-ops if TAB5_TRACE is 0)
+    // Records begin/end spans for update() frames, touch dispatch, element
+    // draws, sprite pushes, text reflows, column sorts and user callbacks.
+    /// Allocates a ring of `events` spans on first enable (false if out of
+    /// memory); the oldest spans are overwritten when it is full.
+    bool setTraceEnabled(bool enable, size_t events = TAB5_TRACE_EVENTS);
+    bool isTraceEnabled() const;
+    void clearTrace();
+    /// Write the buffered spans as Chrome trace-event JSON, for
+    /// chrome://tracing or ui.perfetto.dev.  Works with Serial or a File.
+    void dumpTrace(Print& out) const;
+
+    // ── Touch session recording & replay ── (see UITouchEvent above)
+    /// Allocates the log; false if out of memory.  Restarts any recording.
+    bool startTouchRecording(size_t maxEvents = TAB5_TOUCH_LOG_MAX);
+    void stopTouchRecording();
+    bool isTouchRecording() const { return _recActive; }
+    /// Header + events, or nullptr if nothing was recorded.  Valid until
+    /// the next startTouchRecording().
+    const uint8_t* getTouchLog(size_t& bytes) const;
+    /// Feed a log through update() with a virtual clock that advances
+    /// frameMs per pass, and time every pass.  Blocks until the log has
+    /// played out plus half a second for animations to settle.
+    UIReplayReport replayTouchLog(const uint8_t* log, size_t bytes,
+                                  uint16_t frameMs = 16);
+
+    // ── Render statistics ── (see UIStats above; no-ops if TAB5_STATS is 0)
+    void    setStatsEnabled(bool enable);
+    bool    isStatsEnabled() const;
+    UIStats getStats() const;
+    void    resetStats();
+    /// Live stats box drawn in a screen corner (also enables collection).
+    void    setStatsHud(bool show, HudCorner corner = HudCorner::TOP_RIGHT);
+
 private:
     M5GFX& _gfx;
     std::vector<UIElement*> _elements;
     uint32_t _bgColor = Tab5Theme::BG_DARK;
+    uint32_t _frameBudgetUs = 0;      // 0 = draw everything dirty each pass
+    std::atomic<uint16_t> _batchDepth{0};   // beginUpdate() nesting
+    std::atomic<bool>     _flushPending{false};   // Batch ended, not drawn yet
 
     // Touch state tracking
     bool    _wasTouched     = false;
@@ -2100,6 +3115,53 @@ private:
     int16_t _contentTop    = 0;
     int16_t _contentBottom = 0;   // Set in constructor from runtime screen height
 
+    // Blit back save-under buffers of overlays that have closed and mark
+    // widgets that changed beneath them dirty
+    void restoreClosedOverlays();
+    // Mark every visible element (or container descendant) overlapping the
+    // rect dirty, except `except`
+    void invalidateArea(int16_t x, int16_t y, int16_t w, int16_t h,
+                        const UIElement* except = nullptr);
+
+    // Stats HUD
+    bool          _hudOn     = false;
+    HudCorner     _hudCorner = HudCorner::TOP_RIGHT;
+    unsigned long _hudLastMs = 0;
+    void hudRect(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+    void drawHud();
+
+    // Redraw-region overlay
+    void eraseRedrawOutlines(bool all = false);
+    void drawRedrawOutlines();
+    // Draw the touched widget's new pressed state straight away, ahead of
+    // the rest of drawDirty(), when nothing else would paint over it
+    void drawFeedback(UIElement* e);
+    bool _feedbackDrawn = false;   // Makes the next drawDirty() repaint the HUD
+
+    // Overdraw tracking
+    void endOverdrawPass();
+
+    // Injected touch source (nullptr = display touch panel)
+    TouchSource _touchSource = nullptr;
+    bool readTouch(int16_t& x, int16_t& y);
+
+    // Touch session recording
+    uint8_t*      _recLog    = nullptr;    // Header + events
+    size_t        _recMax    = 0;
+    bool          _recActive = false;
+    bool          _recDown   = false;
+    int16_t       _recX      = -1;
+    int16_t       _recY      = -1;
+    unsigned long _recStart  = 0;
+    void recordTouch(bool down, int16_t x, int16_t y);
+
+    // Time spent in touch handlers by the last update() (0 = none ran)
+    uint32_t _lastDispatchUs = 0;
+
+    // Cross-task queue: copies `bytes` of a closure into a free slot
+    bool postRaw(void (*apply)(void*), const void* closure, size_t bytes);
+    void applyPosted();
+
     // Debounce
     unsigned long _lastTouchTime = 0;
     static constexpr unsigned long TOUCH_DEBOUNCE_MS = 30;
@@ -2114,4 +3176,64 @@ private:
     SleepCallback _onWake  = nullptr;
 };
 
+// ─── UIManager::post() ──────────────────────────────────────────────────────
+namespace tab5ui_detail {
+// Posted arguments are stored by value; strings as a copy
+template <typename P> struct PostArg {
+    using type = typename std::decay<P>::type;
+};
+template <> struct PostArg<const char*> { using type = UIPostString; };
+template <> struct PostArg<char*>       { using type = UIPostString; };
+
+template <typename C, typename R, typename... P>
+struct PostClosure {
+    using Setter = R (C::*)(P...);
+    using Args   = std::tuple<typename PostArg<typename std::decay<P>::type>::type...>;
+    C*     target;
+    Setter setter;
+    Args   args;
+
+    static void apply(void* p) {
+        PostClosure* c = static_cast<PostClosure*>(p);
+        c->call(std::index_sequence_for<P...>());
+    }
+    template <size_t... I>
+    void call(std::index_sequence<I...>) { (target->*setter)(std::get<I>(args)...); }
+};
+} // namespace tab5ui_detail
+
+template <typename W, typename C, typename R, typename... P, typename... A>
+bool UIManager::post(W* target, R (C::*setter)(P...), A&&... args) {
+    using Closure = tab5ui_detail::PostClosure<C, R, P...>;
+    static_assert(sizeof...(A) == sizeof...(P), "post(): wrong number of setter arguments");
+    static_assert(sizeof(Closure) <= TAB5_POST_PAYLOAD,
+                  "post(): arguments too large for a queue slot");
+    static_assert(std::is_trivially_destructible<typename Closure::Args>::value,
+                  "post(): arguments must be plain values or strings");
+    Closure c{ static_cast<C*>(target), setter,
+               typename Closure::Args(std::forward<A>(args)...) };
+    return postRaw(&Closure::apply, &c, sizeof(c));
+}
+
+/*******************************************************************************
+ * UIUpdateGuard — beginUpdate() for the lifetime of a scope
+ *
+ * Usage:
+ *   {
+ *       UIUpdateGuard batch(ui);
+ *       tempLabel.setText(buf);
+ *       table.setCellText(0, 1, "OK");
+ *   }   // endUpdate(): the next update() draws it all in one pass
+ ******************************************************************************/
+class UIUpdateGuard {
+public:
+    explicit UIUpdateGuard(UIManager& ui) : _ui(ui) { _ui.beginUpdate(); }
+    ~UIUpdateGuard() { _ui.endUpdate(); }
+    UIUpdateGuard(const UIUpdateGuard&) = delete;
+    UIUpdateGuard& operator=(const UIUpdateGuard&) = delete;
+
+private:
+    UIManager& _ui;
+};
+
 #endif // TAB5UI_H
@@ -0,0 +1,401 @@
+/*******************************************************************************
+ * Tab5UI_Benchmark.ino — Rendering and layout benchmarks for Tab5UI
+ *
+ * Times the library's hot paths and prints the results as one JSON object
+ * over Serial (115200 baud), so runs can be saved and diffed between
+ * releases.  Nothing is shown on the panel; widgets draw into an offscreen
+ * 1280×720 canvas in PSRAM, so panel transfer time is not included.
+ *
+ * Benchmarks:
+ *   draw/<Widget>          draw() of each widget class
+ *   reflow/ScrollText/<n>  UIScrollText setText() + draw() for n characters
+ *   reflow/TextArea/<n>    UITextArea setText() + draw() for n characters
+ *   sort/ColumnList/<n>    UIColumnList sortByColumn() on n rows
+ *   chart/scroll/<n>       UIChart on a 1000px plot: push n samples to each
+ *                          of 2 series + draw() (in-place scroll)
+ *   chart/full             UIChart full redraw of the same plot
+ *   chart/view/<n>         UIChart redraw of an n-sample zoomed-out view of
+ *                          a 1M-sample series (min/max envelope)
+ *   chart/lttb/<n>         The same view in ChartMode::LINE (LTTB)
+ *   waterfall/<flow>       UIWaterfall 1024×400: pushRow() of 512 bins +
+ *                          draw() (one-line scroll)
+ *   gauge/move             UIGauge 300×300: setValue() + draw() (needle
+ *                          region restored from the cached face)
+ *   gauge/full             UIGauge full redraw from the cached face
+ *   update/idle/<n>        UIManager::update() with n clean buttons
+ *   update/dirty/<n>       UIManager::update() with n dirty buttons
+ *   update/tap/<n>         UIManager::update() dispatching a synthetic tap
+ *                          (injected touch source + virtual clock)
+ *
+ * Sizes are capped by the library's compile-time limits
+ * (TAB5_LIST_MAX_ITEMS rows, TAB5_SCROLLTEXT_MAX_LEN / TAB5_TEXTAREA_MAX_LEN
+ * characters); the caps are included in the JSON.
+ *
+ * Board:   M5Stack Tab5
+ * Library: M5GFX (install via Arduino Library Manager)
+ ******************************************************************************/
+
+#include <M5GFX.h>
+#include "Tab5UI.h"
+
+// ── Display & UI Manager ────────────────────────────────────────────────────
+M5GFX display;
+UIManager ui(display);
+
+// Offscreen render target
+M5Canvas canvas(&display);
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Timing helpers
+// ═════════════════════════════════════════════════════════════════════════════
+static constexpr int MAX_ITERS = 200;
+static bool firstResult = true;
+
+// Run fn `iters` times and print one JSON result object
+template <typename Fn>
+static void bench(const char* name, int iters, Fn fn) {
+    static uint32_t samples[MAX_ITERS];
+    if (iters > MAX_ITERS) iters = MAX_ITERS;
+
+    fn();   // Warm-up: first-use allocations and layout are not measured
+
+    uint64_t sum = 0;
+    for (int i = 0; i < iters; i++) {
+        uint32_t t0 = micros();
+        fn();
+        samples[i] = micros() - t0;
+        sum += samples[i];
+    }
+    std::sort(samples, samples + iters);
+
+    Serial.printf("%s\n    {\"name\":\"%s\",\"iters\":%d,\"min_us\":%lu,"
+                  "\"avg_us\":%lu,\"p50_us\":%lu,\"max_us\":%lu}",
+                  firstResult ? "" : ",", name, iters,
+                  (unsigned long)samples[0],
+                  (unsigned long)(sum / iters),
+                  (unsigned long)samples[iters / 2],
+                  (unsigned long)samples[iters - 1]);
+    firstResult = false;
+}
+
+// Time draw() of a widget into the offscreen canvas
+static void benchDraw(const char* widget, UIElement& e, int iters = 50) {
+    char name[48];
+    snprintf(name, sizeof(name), "draw/%s", widget);
+    bench(name, iters, [&]() { e.draw(canvas); });
+}
+
+// Deterministic filler text of n characters (words of 2–9 letters)
+static void makeText(char* buf, int n) {
+    uint32_t seed = 12345;
+    int i = 0;
+    while (i < n) {
+        seed = seed * 1103515245u + 12345u;
+        int wlen = 2 + (seed >> 16) % 8;
+        for (int k = 0; k < wlen && i < n; k++) buf[i++] = 'a' + (seed >> (k + 3)) % 26;
+        if (i < n) buf[i++] = ((seed >> 20) % 12 == 0) ? '\n' : ' ';
+    }
+    buf[n] = '\0';
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Benchmark groups
+// ═════════════════════════════════════════════════════════════════════════════
+static void benchWidgets() {
+    UILabel lbl(20, 80, 400, TAB5_LABEL_H, "Benchmark label");
+    benchDraw("UILabel", lbl);
+
+    UIButton btn(20, 140, 300, TAB5_BTN_H, "Button");
+    benchDraw("UIButton", btn);
+
+    UISlider sld(20, 220, 600, 40, 0, 100, 42);
+    benchDraw("UISlider", sld);
+
+    UITitleBar title("Benchmark");
+    benchDraw("UITitleBar", title);
+
+    UIStatusBar status("Status text");
+    benchDraw("UIStatusBar", status);
+
+    UITextRow row(20, 280, 600, "Label", "Value");
+    benchDraw("UITextRow", row);
+
+    UIIconSquare sq(700, 80);
+    benchDraw("UIIconSquare", sq);
+
+    UIIconCircle circ(800, 80);
+    benchDraw("UIIconCircle", circ);
+
+    UICheckbox cb(20, 340, 300, 48, "Checkbox", true);
+    benchDraw("UICheckbox", cb);
+
+    UIRadioGroup group;
+    UIRadioButton rb(20, 400, 300, 48, "Radio", &group);
+    benchDraw("UIRadioButton", rb);
+
+    UITextInput input(20, 460, 600, "Placeholder");
+    benchDraw("UITextInput", input);
+
+    UIList list(700, 160, 560, 480);
+    for (int i = 0; i < TAB5_LIST_MAX_ITEMS; i++) {
+        char item[24];
+        snprintf(item, sizeof(item), "Item %d", i);
+        list.addItem(item);
+    }
+    benchDraw("UIList", list);
+
+    UIDropdown dd(20, 520, 400);
+    dd.addItem("One"); dd.addItem("Two"); dd.addItem("Three");
+    benchDraw("UIDropdown", dd);
+
+    UIMenu menu(700, 80);
+    menu.addItem("Open"); menu.addItem("Save"); menu.addItem("Quit");
+    menu.show();
+    benchDraw("UIMenu", menu);
+
+    UIKeyboard kb;
+    kb.show();
+    benchDraw("UIKeyboard", kb);
+
+    UIInfoPopup info("Info", "A short message for the popup body.");
+    info.show();
+    benchDraw("UIInfoPopup", info);
+
+    UIConfirmPopup confirm("Confirm", "Proceed with the operation?");
+    confirm.show();
+    benchDraw("UIConfirmPopup", confirm);
+
+    UITabView tabs(0, TAB5_TITLE_H, TAB5_SCREEN_W, 600);
+    int p0 = tabs.addPage("One");
+    tabs.addPage("Two");
+    UIButton tabBtn(20, tabs.contentY() + 20, 300, TAB5_BTN_H, "On page");
+    tabs.addChild(p0, &tabBtn);
+    benchDraw("UITabView", tabs, 20);
+
+    // Close the overlays so their save-under snapshots are released before
+    // these locals go out of scope
+    menu.hide(); kb.hide(); info.hide(); confirm.hide();
+    ui.drawDirty();
+}
+
+static void benchReflow() {
+    static char text[TAB5_SCROLLTEXT_MAX_LEN];
+    const int stSizes[] = { 256, 512, 1024, TAB5_SCROLLTEXT_MAX_LEN - 1 };
+    UIScrollText st(20, 80, 800, 560);
+    for (int n : stSizes) {
+        makeText(text, n);
+        char name[48];
+        snprintf(name, sizeof(name), "reflow/ScrollText/%d", n);
+        bench(name, 20, [&]() { st.setText(text); st.draw(canvas); });
+    }
+
+    const int taSizes[] = { 128, 256, 512, TAB5_TEXTAREA_MAX_LEN - 1 };
+    UITextArea ta(20, 80, 800, 560);
+    for (int n : taSizes) {
+        makeText(text, n);
+        char name[48];
+        snprintf(name, sizeof(name), "reflow/TextArea/%d", n);
+        bench(name, 20, [&]() { ta.setText(text); ta.draw(canvas); });
+    }
+}
+
+static void benchSort() {
+    const int sizes[] = { 16, 32, TAB5_LIST_MAX_ITEMS };
+    UIColumnList table(20, 80, 900, 560);
+    table.addColumn("Name", 400);
+    table.addColumn("Value", 300);
+    for (int n : sizes) {
+        table.clearSort();
+        table.clearRows();
+        uint32_t seed = 777;
+        for (int i = 0; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            char cell[16];
+            snprintf(cell, sizeof(cell), "row%05lu", (unsigned long)((seed >> 8) % 100000));
+            int r = table.addRow();
+            table.setCellText(r, 0, cell);
+            snprintf(cell, sizeof(cell), "%d", i);
+            table.setCellText(r, 1, cell);
+        }
+        char name[48];
+        snprintf(name, sizeof(name), "sort/ColumnList/%d", n);
+        bool asc = false;
+        bench(name, 50, [&]() {
+            asc = !asc;
+            table.sortByColumn(0, asc ? SortDir::ASC : SortDir::DESC);
+        });
+    }
+}
+
+static void benchChart() {
+    UIChart chart(20, 80, 1000 + 66, 300);   // 1000px plot beside the scale
+    int a = chart.addSeries(Tab5Theme::ACCENT);
+    int b = chart.addSeries(Tab5Theme::PRIMARY);
+    chart.setRange(-1.2f, 1.2f);
+    uint32_t t = 0;
+    auto feed = [&](int n) {
+        for (int i = 0; i < n; i++, t++) {
+            chart.push(sinf(t * 0.05f), a);
+            chart.push(cosf(t * 0.031f), b);
+        }
+    };
+    feed(1000);
+    chart.draw(canvas);
+
+    const int sizes[] = { 1, 4, 16 };
+    for (int n : sizes) {
+        char name[48];
+        snprintf(name, sizeof(name), "chart/scroll/%d", n);
+        bench(name, 100, [&]() { feed(n); chart.draw(canvas); });
+    }
+    bench("chart/full", 20, [&]() { chart.invalidate(); chart.draw(canvas); });
+
+    // Zoomed-out views of a 1M-sample capture (4 MB + pyramid in PSRAM)
+    UIChart big(20, 80, 1000 + 66, 300);
+    int s = big.addSeries(Tab5Theme::ACCENT, 1u << 20);
+    if (s < 0) return;
+    static float block[1024];
+    for (uint32_t i = 0; i < (1u << 20); i += 1024) {
+        for (int k = 0; k < 1024; k++) {
+            uint32_t n = i + k;
+            block[k] = sinf(n * 0.0007f) + 0.2f * sinf(n * 0.9f);
+        }
+        big.pushBlock(block, 1024, s);
+    }
+    const uint32_t spans[] = { 10000, 100000, 1000000 };
+    for (uint32_t n : spans) {
+        char name[48];
+        big.setDrawMode(ChartMode::ENVELOPE);
+        big.setView(n);
+        snprintf(name, sizeof(name), "chart/view/%lu", (unsigned long)n);
+        bench(name, 20, [&]() { big.invalidate(); big.draw(canvas); });
+
+        big.setDrawMode(ChartMode::LINE);
+        snprintf(name, sizeof(name), "chart/lttb/%lu", (unsigned long)n);
+        bench(name, 5, [&]() { big.invalidate(); big.draw(canvas); });
+    }
+}
+
+static void benchWaterfall() {
+    static float bins[512];
+    for (int i = 0; i < 512; i++) bins[i] = (i * 37 % 101) / 100.0f;
+
+    UIWaterfall wf(20, 80, 1024, 400);
+    wf.draw(canvas);
+    bench("waterfall/down", 100, [&]() { wf.pushRow(bins, 512); wf.draw(canvas); });
+    wf.setFlow(WaterfallFlow::LEFT);
+    wf.draw(canvas);
+    bench("waterfall/left", 100, [&]() { wf.pushRow(bins, 512); wf.draw(canvas); });
+}
+
+static void benchGauge() {
+    UIGauge g(20, 80, 300, 300, 0, 8000);
+    g.setTitle("RPM");
+    g.setTicks(8, 5);
+    g.addZone(6500, 8000, Tab5Theme::DANGER);
+    g.draw(canvas);
+    float v = 0;
+    bench("gauge/move", 100, [&]() {
+        v = v >= 7900 ? 0 : v + 97;
+        g.setValue(v);
+        g.draw(canvas);
+    });
+    bench("gauge/full", 50, [&]() { g.invalidate(); g.draw(canvas); });
+}
+
+static void benchUpdate() {
+    static constexpr int MAX_BUTTONS = 128;
+    static UIButton* buttons[MAX_BUTTONS];
+    const int sizes[] = { 8, 32, MAX_BUTTONS };
+
+    for (int n : sizes) {
+        ui.clearElements();
+        for (int i = 0; i < n; i++) {
+            if (!buttons[i]) {
+                int16_t x = 10 + (i % 8) * 158;
+                int16_t y = TAB5_TITLE_H + 10 + (i / 8) * 38;
+                buttons[i] = new UIButton(x, y, 150, 32, "B");
+            }
+            ui.addElement(buttons[i]);
+        }
+        ui.drawAll();
+
+        char name[48];
+        snprintf(name, sizeof(name), "update/idle/%d", n);
+        bench(name, 100, []() { ui.update(); });
+
+        snprintf(name, sizeof(name), "update/dirty/%d", n);
+        bench(name, 20, [n]() {
+            for (int i = 0; i < n; i++) buttons[i]->setDirty();
+            ui.update();
+        });
+
+        // Alternate press/release on the first button (hit-tested last).
+        // The virtual clock steps past the touch debounce on every call.
+        static bool fingerDown = false;
+        static unsigned long virtualMs = 0;
+        ui.setClock([]() { return virtualMs; });
+        ui.setTouchSource([](int16_t& x, int16_t& y) {
+            x = buttons[0]->getX() + 10;
+            y = buttons[0]->getY() + 10;
+            return fingerDown;
+        });
+        snprintf(name, sizeof(name), "update/tap/%d", n);
+        bench(name, 100, []() {
+            fingerDown = !fingerDown;
+            virtualMs += 50;
+            ui.update();
+        });
+        fingerDown = false;
+        ui.update();
+        ui.setTouchSource(nullptr);
+        ui.setClock(nullptr);
+    }
+    ui.clearElements();
+    ui.clearScreen();
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  setup()
+// ═════════════════════════════════════════════════════════════════════════════
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    display.init();
+    display.setRotation(1);           // Landscape
+    Tab5UI::init(display);
+    ui.setBrightness(128);
+    display.setFont(&fonts::DejaVu18);
+    ui.setBackground(Tab5Theme::BG_DARK);
+    ui.clearScreen();
+
+    canvas.setColorDepth(16);
+    canvas.setPsram(true);
+    if (!canvas.createSprite(Tab5UI::screenW(), Tab5UI::screenH())) {
+        Serial.println("{\"error\":\"canvas allocation failed\"}");
+        return;
+    }
+    canvas.setFont(display.getFont());
+
+    Serial.printf("{\n  \"screen\":[%d,%d],\n  \"caps\":{\"list_rows\":%d,"
+                  "\"scrolltext_chars\":%d,\"textarea_chars\":%d},\n"
+                  "  \"results\":[",
+                  Tab5UI::screenW(), Tab5UI::screenH(), TAB5_LIST_MAX_ITEMS,
+                  TAB5_SCROLLTEXT_MAX_LEN - 1, TAB5_TEXTAREA_MAX_LEN - 1);
+    benchWidgets();
+    benchReflow();
+    benchSort();
+    benchChart();
+    benchWaterfall();
+    benchGauge();
+    benchUpdate();
+    Serial.println("\n  ]\n}");
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  loop()
+// ═════════════════════════════════════════════════════════════════════════════
+void loop() {
+    delay(1000);
+}
@@ -0,0 +1,817 @@
+/*******************************************************************************
+ * Tab5UI_RenderCheck.ino — Screenshot and draw-time regression check
+ *
+ * Renders the example screens shown in the screenshots/ folder into an
+ * offscreen 1280×720 canvas and compares them pixel by pixel against those
+ * screenshots, then checks each widget's draw() time against a recorded
+ * budget.  Use it before and after renderer changes to catch visual
+ * regressions and slowdowns.
+ *
+ * Each reference screen rebuilds one screenshot from the widgets, layout
+ * and content of the example that produced it:
+ *   initial, menu, keyboard, popup, confirm_popup   Tab5UI_Demo
+ *   list                                            Tab5UI_List_Demo
+ *   tab_controls, tab_list, tab_text                Tab5UI_Tab_Demo
+ *   column_list                                     Tab5UI_ColumnList_Demo
+ *   scroll_text_popup                               Tab5UI_ScrollTextPopup_Demo
+ * Where an example has changed since its screenshot was taken (version
+ * strings, the confirm popup text, the ColumnList action icons), the screen
+ * follows the screenshot.  Tab5UI_TextArea_Demo runs in portrait and has no
+ * screenshot, so it isn't covered.
+ *
+ * The screenshots are embedded as PNG arrays (screenshots/*.h, generated
+ * like the icons) and decoded with drawPng() into a second canvas.  A pixel
+ * differs when any 8-bit colour channel is off by more than
+ * CHANNEL_TOLERANCE; a screen passes if at most MAX_DIFF_PIXELS differ.
+ * A widget fails its budget if draw() takes more than BUDGET_MARGIN_PCT
+ * percent over the recorded time.  Widgets with no budget are listed as not
+ * recorded and don't fail the run.
+ *
+ * Workflow:
+ *   1. Set RECORD_MODE to true and flash.  The sketch prints a BUDGETS
+ *      table over Serial (115200 baud).
+ *   2. Paste it over the one below, set RECORD_MODE back to false and
+ *      commit it.
+ *   3. Every later run prints PASS/FAIL per screen and per widget.
+ *
+ * The two canvases take 3.6 MB of PSRAM and the screenshots about 1.1 MB
+ * of flash.
+ *
+ * Board:   M5Stack Tab5
+ * Library: M5GFX (install via Arduino Library Manager)
+ ******************************************************************************/
+
+#include <M5GFX.h>
+#include "Tab5UI.h"
+
+// Icons used by the Tab and ColumnList demo screens
+#include "icons/icon_home.h"
+#include "icons/icon_search.h"
+#include "icons/icon_setting.h"
+#include "icons/icon_camera.h"
+
+// Reference screenshots
+#include "screenshots/screenshot1_initial.h"
+#include "screenshots/screenshot2_menu.h"
+#include "screenshots/screenshot3_keyboard.h"
+#include "screenshots/screenshot4_popup.h"
+#include "screenshots/screenshot5_list.h"
+#include "screenshots/screenshot6_tab_controls.h"
+#include "screenshots/screenshot7_tab_list.h"
+#include "screenshots/screenshot8_confirm_popup.h"
+#include "screenshots/screenshot9_tab_text.h"
+#include "screenshots/screenshot10_column_list.h"
+#include "screenshots/screenshot11_scroll_text_popup.h"
+
+// ── Display & UI Manager ────────────────────────────────────────────────────
+M5GFX display;
+UIManager ui(display);
+
+// Offscreen render target, and the decoded screenshot it is compared with
+M5Canvas canvas(&display);
+M5Canvas reference(&display);
+
+// ── Check parameters ────────────────────────────────────────────────────────
+static constexpr bool RECORD_MODE      = false;  // Print budgets instead of checking
+static constexpr int CHANNEL_TOLERANCE = 24;     // Per 8-bit channel, 3 RGB565 red/blue steps
+static constexpr int MAX_DIFF_PIXELS   = 2000;   // Differing pixels allowed per screen (0.2%)
+static constexpr int BUDGET_MARGIN_PCT = 25;     // Allowed draw-time overrun
+static constexpr int DRAW_ITERS        = 10;     // Draws averaged per widget
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Recorded budgets — paste record-mode output here
+// ═════════════════════════════════════════════════════════════════════════════
+// Keyed "<screen>/<index into the screen's element list>"
+struct Budget { const char* key; uint32_t us; };
+static const Budget BUDGETS[] = {
+    { nullptr, 0 }
+};
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Tab5UI_Demo  (initial, menu, keyboard, popup, confirm_popup)
+// ═════════════════════════════════════════════════════════════════════════════
+UITitleBar   dTitleBar("Tab5UI Demo");
+UIStatusBar  dStatusBar("Ready");
+UILabel      dHeader(TAB5_PADDING, 60, 400, TAB5_LABEL_H, "Touch any element below:");
+UIButton     dBtnAction(TAB5_PADDING, 110, 180, TAB5_BTN_H, "Action", Tab5Theme::PRIMARY);
+UIButton     dBtnToggle(200, 110, 180, TAB5_BTN_H, "Toggle", Tab5Theme::SECONDARY);
+UIButton     dBtnDanger(390, 110, 180, TAB5_BTN_H, "Reset", Tab5Theme::DANGER);
+UITextRow    dRow1(TAB5_PADDING, 180, 670, "WiFi Status", "Connected");
+UITextRow    dRow2(TAB5_PADDING, 220, 670, "Battery", "87%");
+UITextRow    dRow3(TAB5_PADDING, 260, 670, "Temperature", "24.5 C");
+UILabel      dCounter(TAB5_PADDING, 310, 500, TAB5_LABEL_H, "Button presses: 0");
+UIIconSquare dIconSq1(TAB5_PADDING,       370, 56, Tab5Theme::PRIMARY);
+UIIconSquare dIconSq2(TAB5_PADDING + 70,  370, 56, Tab5Theme::SECONDARY);
+UIIconSquare dIconSq3(TAB5_PADDING + 140, 370, 56, Tab5Theme::ACCENT);
+UIIconSquare dIconSq4(TAB5_PADDING + 210, 370, 56, Tab5Theme::DANGER);
+UIIconCircle dIconCr1(TAB5_PADDING,       450, 28, Tab5Theme::PRIMARY);
+UIIconCircle dIconCr2(TAB5_PADDING + 70,  450, 28, Tab5Theme::SECONDARY);
+UIIconCircle dIconCr3(TAB5_PADDING + 140, 450, 28, Tab5Theme::ACCENT);
+UIIconCircle dIconCr4(TAB5_PADDING + 210, 450, 28, Tab5Theme::DANGER);
+UICheckbox   dChk1(TAB5_PADDING, 510, 280, 40, "Enable WiFi", true);
+UICheckbox   dChk2(TAB5_PADDING, 550, 280, 40, "Notifications");
+UIRadioGroup dRadioGroup;
+UIRadioButton dRadio1(300, 510, 260, 40, "Option A", &dRadioGroup);
+UIRadioButton dRadio2(300, 550, 260, 40, "Option B", &dRadioGroup);
+UIRadioButton dRadio3(560, 510, 260, 40, "Option C", &dRadioGroup);
+UIButton     dBtnConfirm(TAB5_PADDING, 600, 280, TAB5_BTN_H, "Confirm Action", Tab5Theme::ACCENT);
+UILabel      dConfirmResult(300, 600, 370, TAB5_LABEL_H, "Result: (waiting)");
+UIButton     dBtnLarge(700, 60, 560, 56, "Large Button", Tab5Theme::SURFACE);
+UILabel      dInfo(700, 130, 560, TAB5_LABEL_H, "Tab5UI Library v1.0");
+UITextRow    dRow4(700, 170, 560, "Display", "1280x720");
+UITextRow    dRow5(700, 210, 560, "Touch", "Capacitive");
+UITextRow    dRow6(700, 250, 560, "UI Elements", "18 types");
+UITextInput  dInputName(700, 310, 560, "Enter your name...");
+UITextInput  dInputMsg(700, 370, 560, "Type a message...");
+UILabel      dInputResult(700, 430, 560, TAB5_LABEL_H, "Submitted: (none)");
+UIMenu       dMenu(TAB5_PADDING, TAB5_TITLE_H + 4, 280);
+UIKeyboard   dKeyboard;
+UIInfoPopup  dAbout("About", "Tab5 UI Demo");
+UIConfirmPopup dConfirm("Delete", "Are you sure you want to delete this item?");
+
+// Registration order of Tab5UI_Demo, without its modal elements
+#define DEMO_BASE                                                            \
+    &dTitleBar, &dHeader, &dBtnAction, &dBtnToggle, &dBtnDanger, &dRow1,     \
+    &dRow2, &dRow3, &dCounter, &dIconSq1, &dIconSq2, &dIconSq3, &dIconSq4,   \
+    &dIconCr1, &dIconCr2, &dIconCr3, &dIconCr4, &dChk1, &dChk2, &dRadio1,    \
+    &dRadio2, &dRadio3, &dBtnConfirm, &dConfirmResult, &dBtnLarge, &dInfo,   \
+    &dRow4, &dRow5, &dRow6, &dStatusBar, &dInputName, &dInputMsg,            \
+    &dInputResult
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Tab5UI_List_Demo  (list)
+// ═════════════════════════════════════════════════════════════════════════════
+UITitleBar   lTitleBar("List Demo");
+UIStatusBar  lStatusBar("Select an item from the list");
+UIList       lList(TAB5_PADDING, TAB5_TITLE_H + TAB5_PADDING, 600,
+                   TAB5_SCREEN_H - TAB5_TITLE_H - TAB5_STATUS_H - TAB5_PADDING * 2);
+UILabel      lSelLabel(640, TAB5_TITLE_H + TAB5_PADDING, 620, TAB5_LABEL_H, "Selected: (none)");
+UIButton     lBtnShow(640, TAB5_TITLE_H + TAB5_PADDING + 50, 280, TAB5_BTN_H,
+                      "Show Selected", Tab5Theme::PRIMARY);
+UIButton     lBtnClear(940, TAB5_TITLE_H + TAB5_PADDING + 50, 280, TAB5_BTN_H,
+                       "Clear Selection", Tab5Theme::DANGER);
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Tab5UI_Tab_Demo  (tab_controls, tab_list, tab_text)
+// ═════════════════════════════════════════════════════════════════════════════
+static const int16_t TAB_Y = TAB5_TITLE_H;
+static const int16_t TAB_H = TAB5_SCREEN_H - TAB5_TITLE_H - TAB5_STATUS_H;
+static const int16_t CY    = TAB_Y + TAB5_TAB_BAR_H;
+
+UITitleBar   tTitleBar("Tab Demo");
+UIStatusBar  tStatusBar("Switch between tabs");
+UITabView    tTabs(0, TAB_Y, TAB5_SCREEN_W, TAB_H, TabPosition::TOP);
+
+// Page 0 — "Controls"
+UILabel      tHeader(TAB5_PADDING, CY + TAB5_PADDING, 500, TAB5_LABEL_H,
+                     "Interactive Controls", Tab5Theme::TEXT_SECONDARY, TAB5_FONT_SIZE_SM);
+UIButton     tBtnAction(TAB5_PADDING, CY + 50, 200, TAB5_BTN_H, "Action", Tab5Theme::PRIMARY);
+UIButton     tBtnToggle(220, CY + 50, 200, TAB5_BTN_H, "Toggle", Tab5Theme::SECONDARY);
+UIButton     tBtnAlert(440, CY + 50, 200, TAB5_BTN_H, "Alert", Tab5Theme::DANGER);
+UILabel      tCounter(TAB5_PADDING, CY + 120, 500, TAB5_LABEL_H, "Button presses: 0");
+UITextRow    tRow1(TAB5_PADDING, CY + 165, 620, "Status", "Active");
+UITextRow    tRow3(TAB5_PADDING, CY + 205, 620, "Tab Position", "Top");
+UIIconSquare tIconSq1(TAB5_PADDING,       CY + 260, 52, Tab5Theme::PRIMARY);
+UIIconSquare tIconSq2(TAB5_PADDING + 66,  CY + 260, 52, Tab5Theme::SECONDARY);
+UIIconSquare tIconSq3(TAB5_PADDING + 132, CY + 260, 52, Tab5Theme::ACCENT);
+UIIconCircle tIconCr1(TAB5_PADDING + 220,      CY + 260, 26, Tab5Theme::DANGER);
+UIIconCircle tIconCr2(TAB5_PADDING + 220 + 66, CY + 260, 26, Tab5Theme::PRIMARY);
+UIButton     tBtnTabPos(700, CY + TAB5_PADDING, 540, TAB5_BTN_H,
+                        "Move Tabs to Bottom", Tab5Theme::SURFACE);
+UILabel      tInfo(700, CY + 80, 540, TAB5_LABEL_H,
+                   "This is the Controls tab", Tab5Theme::ACCENT, TAB5_FONT_SIZE_MD);
+UITextRow    tRowDisplay(700, CY + 120, 540, "Display", "1280x720");
+UITextRow    tRowTouch(700, CY + 160, 540, "Touch", "Capacitive");
+UITextRow    tRowWidgets(700, CY + 200, 540, "Widgets", "18 types");
+UITextInput  tInput(700, CY + 250, 540, "Type something...");
+UILabel      tInputResult(700, CY + 310, 540, TAB5_LABEL_H,
+                          "Submitted: (none)", Tab5Theme::ACCENT, TAB5_FONT_SIZE_SM);
+UILabel      tIconBtnLabel(700, CY + 355, 540, TAB5_LABEL_H,
+                           "Icon Buttons:", Tab5Theme::TEXT_SECONDARY, TAB5_FONT_SIZE_SM);
+UIIconButton tIconBtn1(700, CY + 395, 56, 56, "Home",     icon_home,    icon_home_size,    Tab5Theme::PRIMARY);
+UIIconButton tIconBtn2(770, CY + 395, 56, 56, "Search",   icon_search,  icon_search_size,  Tab5Theme::SECONDARY);
+UIIconButton tIconBtn3(840, CY + 395, 56, 56, "Settings", icon_setting, icon_setting_size, Tab5Theme::ACCENT);
+UIIconButton tIconBtn4(910, CY + 395, 56, 56, "Camera",   icon_camera,  icon_camera_size,  Tab5Theme::DANGER);
+UISlider     tSlider(700, CY + 460, 540, 60, 0, 100, 50);
+UICheckbox   tChk1(TAB5_PADDING, CY + 330, 300, 40, "Enable WiFi", true);
+UICheckbox   tChk2(TAB5_PADDING, CY + 370, 300, 40, "Dark Mode");
+UICheckbox   tChk3(TAB5_PADDING, CY + 410, 300, 40, "Notifications");
+UIRadioGroup tRadioGroup;
+UIRadioButton tRadio1(TAB5_PADDING + 320, CY + 330, 300, 40, "Profile A", &tRadioGroup);
+UIRadioButton tRadio2(TAB5_PADDING + 320, CY + 370, 300, 40, "Profile B", &tRadioGroup);
+UIRadioButton tRadio3(TAB5_PADDING + 320, CY + 410, 300, 40, "Profile C", &tRadioGroup);
+UIButton     tBtnConfirm(TAB5_PADDING, CY + 470, 300, TAB5_BTN_H, "Confirm Action", Tab5Theme::ACCENT);
+UILabel      tConfirmResult(TAB5_PADDING + 320, CY + 470, 310, TAB5_LABEL_H,
+                            "Result: (waiting)", Tab5Theme::ACCENT, TAB5_FONT_SIZE_SM);
+
+// Page 1 — "Data List"
+UIList       tDataList(TAB5_PADDING, CY + TAB5_PADDING,
+                       600, TAB_H - TAB5_TAB_BAR_H - TAB5_PADDING * 2);
+UILabel      tListSel(640, CY + TAB5_PADDING, 620, TAB5_LABEL_H, "Selected: (none)");
+UIButton     tBtnShowSel(640, CY + TAB5_PADDING + 50, 280, TAB5_BTN_H,
+                         "Show Selected", Tab5Theme::PRIMARY);
+UIButton     tBtnClearSel(940, CY + TAB5_PADDING + 50, 280, TAB5_BTN_H,
+                          "Clear Selection", Tab5Theme::DANGER);
+UILabel      tDropLabel(640, CY + TAB5_PADDING + 120, 620, TAB5_LABEL_H, "Dropdown:");
+UIDropdown   tDropdown(640, CY + TAB5_PADDING + 155, 580, TAB5_BTN_H, "Choose a category...");
+
+// Page 2 — "Text"
+UIScrollText tScrollText(TAB5_PADDING, CY + TAB5_PADDING,
+                         TAB5_SCREEN_W - TAB5_PADDING * 2,
+                         TAB_H - TAB5_TAB_BAR_H - TAB5_PADDING * 2);
+
+static const char TAB_TEXT[] =
+    "# Tab5UI Library Overview\n\n"
+    "**Tab5UI** is a lightweight, Arduino-compatible touchscreen UI widget "
+    "library built on `M5GFX` for the M5Stack Tab5's 5-inch *1280x720* IPS "
+    "capacitive touchscreen.\n\n"
+    "The library provides a comprehensive set of interactive widgets including "
+    "buttons, labels, text rows, icon squares, icon circles, popup menus, "
+    "on-screen keyboards, text input fields, scrollable lists, tabbed views, "
+    "info popups, confirm popups, and scrollable text displays.\n\n"
+    "---\n\n"
+    "## Key Features\n\n"
+    "- **16 widget types** covering common UI patterns\n"
+    "- Touch-drag scrolling for *lists* and *text*\n"
+    "- Modal overlays for menus, keyboards, and popups\n"
+    "- Auto-sizing popups with `word-wrapping`\n"
+    "- Tabbed views with top or bottom tab bar placement\n"
+    "- Customizable colors and text sizes\n"
+    "- Efficient **dirty-rectangle** redraw system\n"
+    "- Designed for the *1280x720* resolution of the Tab5\n\n"
+    "---\n\n"
+    "### Markdown Support\n\n"
+    "This widget now renders basic Markdown: **bold**, *italic*, "
+    "`inline code`, headings, bullet lists, and horizontal rules. "
+    "Try scrolling to see it all!";
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Tab5UI_ColumnList_Demo  (column_list)
+// ═════════════════════════════════════════════════════════════════════════════
+UITitleBar   cTitleBar("Column List Demo");
+UIStatusBar  cStatusBar("Tap a header to sort, tap a row to select");
+UIColumnList cTable(TAB5_PADDING, TAB5_TITLE_H + TAB5_PADDING, 920,
+                    TAB5_SCREEN_H - TAB5_TITLE_H - TAB5_STATUS_H - TAB5_PADDING * 2);
+UILabel      cSelLabel(950, TAB5_TITLE_H + TAB5_PADDING, 310, TAB5_LABEL_H, "Selected: (none)");
+UIButton     cBtnClear(950, TAB5_TITLE_H + TAB5_PADDING + 50, 310, TAB5_BTN_H,
+                       "Clear Selection", Tab5Theme::DANGER);
+UIButton     cBtnScroll(950, TAB5_TITLE_H + TAB5_PADDING + 120, 310, TAB5_BTN_H,
+                        "Scroll to Bottom", Tab5Theme::PRIMARY);
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Tab5UI_ScrollTextPopup_Demo  (scroll_text_popup)
+// ═════════════════════════════════════════════════════════════════════════════
+UITitleBar   sTitleBar("ScrollTextPopup Demo");
+UIStatusBar  sStatusBar("Ready");
+UILabel      sHeader(TAB5_PADDING, 70, 600, TAB5_LABEL_H,
+                     "Tap a button to open a scrollable popup:");
+UIButton     sBtnHelp(TAB5_PADDING, 130, 380, TAB5_BTN_H, "Help / Guide", Tab5Theme::PRIMARY);
+UIButton     sBtnRelease(TAB5_PADDING, 200, 380, TAB5_BTN_H, "Release Notes", Tab5Theme::SECONDARY);
+UIButton     sBtnLicense(TAB5_PADDING, 270, 380, TAB5_BTN_H, "License", Tab5Theme::ACCENT);
+UILabel      sLastAction(TAB5_PADDING, 350, 600, TAB5_LABEL_H, "Last action: (none)");
+UITextRow    sRow1(500, 130, 760, "Widget", "UIScrollTextPopup");
+UITextRow    sRow2(500, 170, 760, "Markdown", "Headings, bold, italic, code");
+UITextRow    sRow3(500, 210, 760, "Scrolling", "Touch-drag to scroll");
+UITextRow    sRow4(500, 250, 760, "Dismiss", "Close button or tap outside");
+
+static const char HELP_TEXT[] =
+    "# Getting Started\n"
+    "\n"
+    "Welcome to the **Tab5UI** library! This guide covers the basics "
+    "of building user interfaces for the *M5Stack Tab5*.\n"
+    "\n"
+    "---\n"
+    "\n"
+    "## Creating Elements\n"
+    "\n"
+    "All UI elements inherit from `UIElement`. Common widgets include:\n"
+    "\n"
+    "- **UIButton** — Tappable buttons with color themes\n"
+    "- **UILabel** — Static or dynamic text labels\n"
+    "- **UITextRow** — Key-value rows for displaying info\n"
+    "- **UIList** — Scrollable lists with selection\n"
+    "- **UIScrollText** — Scrollable Markdown text areas\n"
+    "- **UIColumnList** — Multi-column sortable lists\n"
+    "\n"
+    "## Adding to UIManager\n"
+    "\n"
+    "Register elements with `ui.add(&element)` in `setup()`. "
+    "The UIManager handles drawing and touch routing automatically.\n"
+    "\n"
+    "### Touch Events\n"
+    "\n"
+    "Use `setOnTouch()` and `setOnRelease()` callbacks:\n"
+    "\n"
+    "- `TOUCH` fires on finger down\n"
+    "- `TOUCH_RELEASE` fires on finger up\n"
+    "\n"
+    "### Layout Tips\n"
+    "\n"
+    "The Tab5 display is **1280x720** pixels. The title bar uses "
+    "the top `48px` and the status bar uses the bottom `36px`, "
+    "leaving **636px** of vertical space for your content.\n"
+    "\n"
+    "---\n"
+    "\n"
+    "## Popups\n"
+    "\n"
+    "Three popup types are available:\n"
+    "\n"
+    "- `UIInfoPopup` — Simple message with an *OK* button\n"
+    "- `UIConfirmPopup` — Yes/No confirmation dialog\n"
+    "- `UIScrollTextPopup` — Large scrollable text with **Markdown**\n"
+    "\n"
+    "All popups are **modal** and can be dismissed by tapping the "
+    "close button or tapping outside the popup area.\n"
+    "\n"
+    "---\n"
+    "\n"
+    "### Markdown Support\n"
+    "\n"
+    "The following Markdown is rendered:\n"
+    "\n"
+    "- `# Heading 1` — Large heading with underline\n"
+    "- `## Heading 2` — Medium heading\n"
+    "- `### Heading 3` — Small heading\n"
+    "- `**bold**` — Bold text in accent color\n"
+    "- `*italic*` — Italic text in secondary color\n"
+    "- Backtick for `inline code` with background\n"
+    "- `- item` — Bullet lists\n"
+    "- `---` — Horizontal rules\n";
+
+UIScrollTextPopup sHelpPopup("Help & Guide", HELP_TEXT);
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Reference screens — one per screenshots/ file
+// ═════════════════════════════════════════════════════════════════════════════
+struct Screen {
+    const char*    name;
+    UIElement**    elements;
+    int            count;
+    const uint8_t* png;          // Screenshot to compare against
+    uint32_t       pngSize;
+    void         (*prepare)();   // Put the screen's widgets into its state
+};
+
+UIElement* initialElems[]  = { DEMO_BASE };
+UIElement* menuElems[]     = { DEMO_BASE, &dMenu };
+UIElement* keyboardElems[] = { DEMO_BASE, &dKeyboard };
+UIElement* popupElems[]    = { DEMO_BASE, &dAbout };
+UIElement* confirmElems[]  = { DEMO_BASE, &dConfirm };
+UIElement* listElems[]     = { &lTitleBar, &lList, &lSelLabel, &lBtnShow,
+                               &lBtnClear, &lStatusBar };
+UIElement* tabElems[]      = { &tTitleBar, &tTabs, &tStatusBar };
+UIElement* columnElems[]   = { &cTitleBar, &cTable, &cSelLabel, &cBtnClear,
+                               &cBtnScroll, &cStatusBar };
+UIElement* scrollElems[]   = { &sTitleBar, &sHeader, &sBtnHelp, &sBtnRelease,
+                               &sBtnLicense, &sLastAction, &sRow1, &sRow2,
+                               &sRow3, &sRow4, &sStatusBar, &sHelpPopup };
+
+// Each prepare*() reproduces the taps that led to its screenshot
+static void prepareInitial() {
+    dInputName.blur();             // Undo the keyboard screen
+    dInputName.clear();
+}
+static void prepareMenu()     { prepareInitial(); dMenu.show(); }
+static void preparePopup()    { prepareInitial(); dAbout.show(); }
+static void prepareConfirm()  { prepareInitial(); dConfirm.show(); }
+static void prepareKeyboard() {
+    dInputName.setText("Hello");
+    dInputName.focus();            // Opens dKeyboard
+}
+
+static void prepareList() {
+    lList.setSelectedIndex(12);
+    lSelLabel.setText("Selected: Mango (#13)");
+    lStatusBar.setText("Selected: Mango (#13)");
+}
+
+static void prepareTabControls() {
+    tTabs.setActivePage(0);
+    tStatusBar.setText("Switch between tabs");
+}
+static void prepareTabList() {
+    tTabs.setActivePage(1);
+    tDataList.setSelectedIndex(1);
+    tListSel.setText("Selected: Messages (#2)");
+    tStatusBar.setText("Selected: Messages (#2)");
+}
+static void prepareTabText() {
+    tTabs.setActivePage(2);
+    tStatusBar.setText("Switched to: Text");
+}
+
+static void prepareColumnList() {
+    cTable.sortByColumn(0);
+    cTable.setSelectedIndex(5);
+    cSelLabel.setText("Selected: Charlie-02 (row 6)");
+}
+
+static void prepareScrollText() {
+    sHelpPopup.show();
+    sStatusBar.setText("Showing help");
+}
+
+#define SCREEN(name, elems, png, prepare) \
+    { name, elems, (int)(sizeof(elems) / sizeof(elems[0])), png, png##_size, prepare }
+static const Screen SCREENS[] = {
+    SCREEN("initial",           initialElems,  screenshot_initial,           prepareInitial),
+    SCREEN("menu",              menuElems,     screenshot_menu,              prepareMenu),
+    SCREEN("keyboard",          keyboardElems, screenshot_keyboard,          prepareKeyboard),
+    SCREEN("popup",             popupElems,    screenshot_popup,             preparePopup),
+    SCREEN("list",              listElems,     screenshot_list,              prepareList),
+    SCREEN("tab_controls",      tabElems,      screenshot_tab_controls,      prepareTabControls),
+    SCREEN("tab_list",          tabElems,      screenshot_tab_list,          prepareTabList),
+    SCREEN("confirm_popup",     confirmElems,  screenshot_confirm_popup,     prepareConfirm),
+    SCREEN("tab_text",          tabElems,      screenshot_tab_text,          prepareTabText),
+    SCREEN("column_list",       columnElems,   screenshot_column_list,       prepareColumnList),
+    SCREEN("scroll_text_popup", scrollElems,   screenshot_scroll_text_popup, prepareScrollText),
+};
+
+// ── Per-demo setup, as in each example's setup() ───────────────────────────
+static void buildDemo() {
+    dTitleBar.setLeftText("< Menu");
+    dTitleBar.setRightText("Settings");
+
+    dMenu.addItem("New Project");
+    dMenu.addItem("Open File");
+    dMenu.addItem("Save");
+    dMenu.addSeparator();
+    dMenu.addItem("About");
+    dMenu.setItemEnabled(2, false);
+    dInputName.attachKeyboard(&dKeyboard);
+
+    dInputResult.setTextColor(Tab5Theme::ACCENT);
+    dInputResult.setTextSize(TAB5_FONT_SIZE_SM);
+    dBtnLarge.setBorderColor(Tab5Theme::PRIMARY);
+
+    dIconSq1.setIconChar("W");
+    dIconSq2.setIconChar("B");
+    dIconSq3.setIconChar("T");
+    dIconSq4.setIconChar("!");
+    dIconCr1.setIconChar("1");
+    dIconCr2.setIconChar("2");
+    dIconCr3.setIconChar("3");
+    dIconCr4.setIconChar("4");
+
+    dHeader.setTextColor(Tab5Theme::TEXT_SECONDARY);
+    dHeader.setTextSize(TAB5_FONT_SIZE_SM);
+    dInfo.setTextColor(Tab5Theme::TEXT_SECONDARY);
+    dInfo.setTextSize(TAB5_FONT_SIZE_SM);
+    dInfo.setAlign(textdatum_t::middle_left);
+    dConfirmResult.setTextColor(Tab5Theme::ACCENT);
+    dConfirmResult.setTextSize(TAB5_FONT_SIZE_SM);
+    dConfirmResult.setAlign(textdatum_t::middle_left);
+
+    dRow6.setShowDivider(false);
+    dStatusBar.setLeftText("Tab5");
+    dStatusBar.setRightText("v1.0");
+}
+
+static void buildList() {
+    lList.addItem("Apple",       "A", Tab5Theme::DANGER);
+    lList.addItem("Banana",      "B", Tab5Theme::ACCENT);
+    lList.addItem("Cherry",      "C", Tab5Theme::DANGER);
+    lList.addItem("Date",        "D", Tab5Theme::ACCENT);
+    lList.addItem("Elderberry",  "E", Tab5Theme::SECONDARY);
+    lList.addItem("Fig",         "F", Tab5Theme::SECONDARY, true);
+    lList.addItem("Grape",       "G", Tab5Theme::PRIMARY,   true);
+    lList.addItem("Honeydew",    "H", Tab5Theme::SECONDARY, true);
+    const char* plain[] = { "Indian Fig", "Jackfruit", "Kiwi", "Lemon", "Mango",
+                            "Nectarine", "Orange" };
+    for (const char* item : plain) lList.addItem(item);
+    lList.setItemIcon(12, "M", Tab5Theme::ACCENT);
+    lList.setItemIcon(14, "O", Tab5Theme::PRIMARY, true);
+    const char* more[] = { "Papaya", "Quince", "Raspberry", "Strawberry", "Tangerine",
+                           "Ugli Fruit", "Vanilla Bean", "Watermelon", "Ximenia",
+                           "Yuzu", "Zucchini" };
+    for (const char* item : more) lList.addItem(item);
+    lList.setTextSize(TAB5_FONT_SIZE_MD);
+
+    lSelLabel.setTextColor(Tab5Theme::ACCENT);
+    lSelLabel.setTextSize(TAB5_FONT_SIZE_MD);
+    lStatusBar.setLeftText("Tab5");
+    lStatusBar.setRightText("List Demo");
+}
+
+static void buildTabs() {
+    int page0 = tTabs.addPage("Controls");
+    int page1 = tTabs.addPage("Data List");
+    int page2 = tTabs.addPage("Text");
+
+    tIconSq1.setIconChar("W");
+    tIconSq2.setIconChar("B");
+    tIconSq3.setIconChar("T");
+    tIconCr1.setIconChar("!");
+    tIconCr2.setIconChar("?");
+    tRowWidgets.setShowDivider(false);
+    tSlider.setShowLabel(true);
+    tSlider.setShowValue(true);
+    tSlider.setLabel("Brightness: 50");
+    tBtnTabPos.setBorderColor(Tab5Theme::PRIMARY);
+
+    UIElement* controls[] = {
+        &tHeader, &tBtnAction, &tBtnToggle, &tBtnAlert, &tCounter, &tRow1, &tRow3,
+        &tIconSq1, &tIconSq2, &tIconSq3, &tIconCr1, &tIconCr2, &tBtnTabPos, &tInfo,
+        &tRowDisplay, &tRowTouch, &tRowWidgets, &tInput, &tInputResult, &tChk1,
+        &tChk2, &tChk3, &tRadio1, &tRadio2, &tRadio3, &tBtnConfirm, &tConfirmResult,
+        &tIconBtnLabel, &tIconBtn1, &tIconBtn2, &tIconBtn3, &tIconBtn4, &tSlider
+    };
+    for (UIElement* e : controls) tTabs.addChild(page0, e);
+
+    tDataList.addItem("Dashboard",    "D", Tab5Theme::PRIMARY);
+    tDataList.addItem("Messages",     "M", Tab5Theme::ACCENT);
+    tDataList.addItem("Contacts",     "C", Tab5Theme::SECONDARY);
+    tDataList.addItem("Calendar",     "C", Tab5Theme::DANGER);
+    tDataList.addItem("Tasks",        "T", Tab5Theme::PRIMARY,   true);
+    tDataList.addItem("Notes",        "N", Tab5Theme::SECONDARY, true);
+    tDataList.addItem("Files",        "F", Tab5Theme::ACCENT,    true);
+    const char* items[] = { "Photos", "Music", "Videos", "Downloads", "Bookmarks",
+                            "History", "Preferences", "Network", "Bluetooth",
+                            "Display", "Sound", "Battery", "Storage" };
+    for (const char* item : items) tDataList.addItem(item);
+    tDataList.setTextSize(TAB5_FONT_SIZE_MD);
+    tListSel.setTextColor(Tab5Theme::ACCENT);
+    tListSel.setTextSize(TAB5_FONT_SIZE_MD);
+
+    tDropdown.addItem("General",     "G", Tab5Theme::PRIMARY);
+    tDropdown.addItem("Work",        "W", Tab5Theme::SECONDARY);
+    tDropdown.addItem("Personal",    "P", Tab5Theme::ACCENT);
+    tDropdown.addItem("Finance",     "F", Tab5Theme::DANGER);
+    tDropdown.addItem("Health",      "H", Tab5Theme::SECONDARY, true);
+    tDropdown.addItem("Travel",      "T", Tab5Theme::PRIMARY,   true);
+    tDropdown.addItem("Education",   "E", Tab5Theme::ACCENT,    true);
+    tDropdown.addItem("Shopping");
+    tDropdown.addItem("Entertainment");
+    tDropdown.addItem("Social");
+    tDropdown.setTextSize(TAB5_FONT_SIZE_MD);
+    tDropLabel.setTextColor(Tab5Theme::TEXT_SECONDARY);
+    tDropLabel.setTextSize(TAB5_FONT_SIZE_MD);
+
+    tTabs.addChild(page1, &tDataList);
+    tTabs.addChild(page1, &tListSel);
+    tTabs.addChild(page1, &tBtnShowSel);
+    tTabs.addChild(page1, &tBtnClearSel);
+    tTabs.addChild(page1, &tDropLabel);
+    tTabs.addChild(page1, &tDropdown);
+
+    tScrollText.setText(TAB_TEXT);
+    tTabs.addChild(page2, &tScrollText);
+
+    tTitleBar.setLeftText("< Back");
+    tTitleBar.setRightText("v1.0");
+    tStatusBar.setLeftText("Tab5");
+    tStatusBar.setRightText("Tab Demo");
+}
+
+static uint32_t statusColor(const char* status) {
+    if (strcmp(status, "Online") == 0 || strcmp(status, "OK") == 0)     return Tab5Theme::SECONDARY;
+    if (strcmp(status, "Idle") == 0 || strcmp(status, "Warning") == 0)  return Tab5Theme::ACCENT;
+    if (strcmp(status, "Offline") == 0 || strcmp(status, "Critical") == 0) return Tab5Theme::DANGER;
+    return Tab5Theme::TEXT_PRIMARY;
+}
+
+static void buildColumnList() {
+    cTable.addColumn("Server", 280);
+    cTable.addColumn("Status", 150, textdatum_t::middle_center);
+    cTable.addColumn("Health", 140, textdatum_t::middle_center);
+    cTable.addColumn("Load",   160, textdatum_t::middle_center);
+    cTable.addColumn("Action", 160, textdatum_t::middle_center);
+
+    // The screenshot predates the per-server action icons: every row
+    // shows icon_home
+    struct ServerInfo {
+        const char* name;
+        const char* status;
+        const char* health;
+        const char* load;
+    };
+    const ServerInfo servers[] = {
+        { "Alpha-01",   "Online",  "OK",       "23%" },
+        { "Alpha-02",   "Online",  "OK",       "45%" },
+        { "Bravo-01",   "Idle",    "Warning",  "78%" },
+        { "Bravo-02",   "Online",  "OK",       "12%" },
+        { "Charlie-01", "Offline", "Critical", "0%"  },
+        { "Charlie-02", "Online",  "OK",       "56%" },
+        { "Delta-01",   "Idle",    "Warning",  "89%" },
+        { "Delta-02",   "Online",  "OK",       "34%" },
+        { "Echo-01",    "Offline", "Critical", "0%"  },
+        { "Echo-02",    "Online",  "OK",       "67%" },
+        { "Foxtrot-01", "Online",  "OK",       "41%" },
+        { "Foxtrot-02", "Idle",    "Warning",  "92%" },
+        { "Golf-01",    "Online",  "OK",       "15%" },
+        { "Golf-02",    "Offline", "Critical", "0%"  },
+        { "Hotel-01",   "Online",  "OK",       "29%" },
+        { "Hotel-02",   "Online",  "OK",       "53%" },
+        { "India-01",   "Idle",    "Warning",  "81%" },
+        { "India-02",   "Online",  "OK",       "38%" },
+        { "Juliet-01",  "Online",  "OK",       "22%" },
+        { "Juliet-02",  "Offline", "Critical", "0%"  },
+    };
+    for (const ServerInfo& s : servers) {
+        int row = cTable.addRow();
+        cTable.setCellText(row, 0, s.name);
+        cTable.setCellText(row, 1, s.status, statusColor(s.status));
+        cTable.setCellText(row, 2, s.health, statusColor(s.health));
+        cTable.setCellText(row, 3, s.load);
+        cTable.setCellIcon(row, 4, icon_home, icon_home_size);
+    }
+    cTable.setRowEnabled(4, false);
+    cTable.setColumnSortable(4, false);
+    cTable.setTextSize(TAB5_FONT_SIZE_MD);
+    cTable.setHeaderBgColor(Tab5Theme::SURFACE);
+    cTable.setHeaderTextColor(Tab5Theme::TEXT_PRIMARY);
+    cTable.setShowColumnDividers(true);
+
+    cSelLabel.setTextColor(Tab5Theme::ACCENT);
+    cSelLabel.setTextSize(TAB5_FONT_SIZE_MD);
+    cStatusBar.setLeftText("Tab5");
+    cStatusBar.setRightText("ColumnList Demo");
+}
+
+static void buildScrollTextPopup() {
+    sStatusBar.setLeftText("Tab5");
+    sStatusBar.setRightText("Demo");
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  Checks
+// ═════════════════════════════════════════════════════════════════════════════
+static constexpr int MAX_ELEMENTS = 40;
+static int failures = 0;
+static int unbudgeted = 0;
+
+static const Budget* findBudget(const char* key) {
+    for (const Budget& b : BUDGETS) {
+        if (b.key && strcmp(b.key, key) == 0) return &b;
+    }
+    return nullptr;
+}
+
+// Render a screen into the canvas the way UIManager paints a full frame
+static void renderScreen(const Screen& scr) {
+    scr.prepare();
+    canvas.fillScreen(lgfx::color888(0x1A, 0x1A, 0x2E));   // Tab5Theme::BG_DARK
+    for (int i = 0; i < scr.count; i++) scr.elements[i]->draw(canvas);
+}
+
+// Time each element's draw() on top of the rendered screen
+static void timeScreen(const Screen& scr, uint32_t* drawUs) {
+    for (int i = 0; i < scr.count; i++) {
+        UIElement* e = scr.elements[i];
+        uint32_t t0 = micros();
+        for (int k = 0; k < DRAW_ITERS; k++) e->draw(canvas);
+        drawUs[i] = (micros() - t0) / DRAW_ITERS;
+    }
+}
+
+// RGB565 channel expanded to 8 bits
+static inline int ch5(uint16_t p, int shift) { int v = (p >> shift) & 0x1F; return (v << 3) | (v >> 2); }
+static inline int ch6(uint16_t p, int shift) { int v = (p >> shift) & 0x3F; return (v << 2) | (v >> 4); }
+
+static bool pixelDiffers(uint16_t a, uint16_t b) {
+    if (a == b) return false;
+    a = __builtin_bswap16(a);   // Sprite buffers hold byte-swapped RGB565
+    b = __builtin_bswap16(b);
+    return abs(ch5(a, 11) - ch5(b, 11)) > CHANNEL_TOLERANCE ||
+           abs(ch6(a, 5)  - ch6(b, 5))  > CHANNEL_TOLERANCE ||
+           abs(ch5(a, 0)  - ch5(b, 0))  > CHANNEL_TOLERANCE;
+}
+
+static void checkImage(const Screen& scr) {
+    reference.fillScreen(0);
+    if (!reference.drawPng(scr.png, scr.pngSize, 0, 0)) {
+        failures++;
+        Serial.printf("  FAIL image  %-24s screenshot failed to decode\n", scr.name);
+        return;
+    }
+
+    const uint16_t* got  = (const uint16_t*)canvas.getBuffer();
+    const uint16_t* want = (const uint16_t*)reference.getBuffer();
+    int diff = 0;
+    int x0 = TAB5_SCREEN_W, y0 = TAB5_SCREEN_H, x1 = -1, y1 = -1;
+    for (int y = 0; y < TAB5_SCREEN_H; y++) {
+        const int row = y * TAB5_SCREEN_W;
+        for (int x = 0; x < TAB5_SCREEN_W; x++) {
+            if (!pixelDiffers(got[row + x], want[row + x])) continue;
+            diff++;
+            if (x < x0) x0 = x;
+            if (x > x1) x1 = x;
+            if (y < y0) y0 = y;
+            y1 = y;
+        }
+    }
+
+    bool ok = diff <= MAX_DIFF_PIXELS;
+    if (!ok) failures++;
+    Serial.printf("  %-4s image  %-24s %d pixels differ (max %d)\n",
+                  ok ? "PASS" : "FAIL", scr.name, diff, MAX_DIFF_PIXELS);
+    if (diff) Serial.printf("       within (%d,%d)-(%d,%d)\n", x0, y0, x1, y1);
+}
+
+static void checkBudgets(const Screen& scr) {
+    static uint32_t drawUs[MAX_ELEMENTS];
+    timeScreen(scr, drawUs);
+
+    int missing = 0;
+    for (int i = 0; i < scr.count; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "%s/%d", scr.name, i);
+        const Budget* b = findBudget(key);
+        if (!b) { missing++; continue; }
+        uint32_t limit = b->us + b->us * BUDGET_MARGIN_PCT / 100;
+        bool ok = drawUs[i] <= limit;
+        if (!ok) failures++;
+        Serial.printf("  %-4s budget %-24s %6lu us (budget %lu us)\n",
+                      ok ? "PASS" : "FAIL", key, (unsigned long)drawUs[i],
+                      (unsigned long)b->us);
+    }
+    if (missing) {
+        unbudgeted += missing;
+        Serial.printf("  ---- budget %-24s %d of %d widgets not recorded\n",
+                      scr.name, missing, scr.count);
+    }
+}
+
+// Print a BUDGETS table ready to paste into this sketch
+static void recordAll() {
+    static uint32_t drawUs[MAX_ELEMENTS];
+
+    Serial.println("static const Budget BUDGETS[] = {");
+    for (const Screen& scr : SCREENS) {
+        renderScreen(scr);
+        timeScreen(scr, drawUs);
+        for (int i = 0; i < scr.count; i++) {
+            Serial.printf("    { \"%s/%d\", %lu },\n", scr.name, i,
+                          (unsigned long)drawUs[i]);
+        }
+    }
+    Serial.println("    { nullptr, 0 }\n};");
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  setup()
+// ═════════════════════════════════════════════════════════════════════════════
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    display.init();
+    display.setRotation(1);           // Landscape
+    Tab5UI::init(display);
+    ui.setBrightness(128);
+    display.setFont(&fonts::DejaVu18);
+
+    canvas.setColorDepth(16);
+    canvas.setPsram(true);
+    reference.setColorDepth(16);
+    reference.setPsram(true);
+    if (!canvas.createSprite(TAB5_SCREEN_W, TAB5_SCREEN_H) ||
+        !reference.createSprite(TAB5_SCREEN_W, TAB5_SCREEN_H)) {
+        Serial.println("Render check: canvas allocation failed");
+        return;
+    }
+    canvas.setFont(display.getFont());
+
+    buildDemo();
+    buildList();
+    buildTabs();
+    buildColumnList();
+    buildScrollTextPopup();
+
+    if (RECORD_MODE) {
+        Serial.println("Render check: RECORD mode");
+        recordAll();
+    } else {
+        Serial.println("Render check:");
+        for (const Screen& scr : SCREENS) {
+            renderScreen(scr);
+            checkImage(scr);
+            checkBudgets(scr);
+        }
+        Serial.printf("Render check: %s (%d failure%s)\n",
+                      failures ? "FAIL" : "PASS", failures, failures == 1 ? "" : "s");
+        if (unbudgeted) {
+            Serial.printf("Render check: %d widgets have no draw-time budget; "
+                          "run once with RECORD_MODE to record them\n", unbudgeted);
+        }
+    }
+
+    // Show the last rendered screen on the panel, then close the modal
+    // elements so their save-under snapshots are released
+    canvas.pushSprite(&display, 0, 0);
+    reference.deleteSprite();
+    dMenu.hide();
+    dKeyboard.hide();
+    dAbout.hide();
+    dConfirm.hide();
+    sHelpPopup.hide();
+    ui.drawDirty();
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+//  loop()
+// ═════════════════════════════════════════════════════════════════════════════
+void loop() {
+    delay(1000);
+}
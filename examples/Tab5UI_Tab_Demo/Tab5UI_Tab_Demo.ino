@@ -535,6 +535,10 @@ void setup() {
         statusBar.setText(buf);
     });
 
+    // Keep rendered pages in PSRAM so switching back is a single blit
+    tabs.setPageCacheBudget(6 * 1024 * 1024);
+    tabs.setTransition(TabTransition::SLIDE, 200);
+
     // ── Style tweaks ────────────────────────────────────────────────────────
     titleBar.setLeftText("< Back");
     titleBar.setRightText("v1.1");